@@ -0,0 +1,167 @@
+/**
+ * Event scanner benchmark
+ *
+ * Replays a recorded socket2 stream (e.g. tests/data/session.events) through the
+ * strchr/strncmp splitter the reader used to have and through
+ * event_scan_lines() + event_classify() with every implementation this CPU
+ * supports. Fails if the implementations disagree on what they found.
+ *
+ * Usage: bench_event_scan STREAM [MEGABYTES]
+ */
+
+#include "event_scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCAN_SPANS 64
+
+typedef struct {
+    size_t lines;
+    size_t handled;   // Lines classified as an event the module handles
+    size_t checksum;  // Sum of (type + 1) * payload offset, to compare implementations
+} ScanResult;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The previous reader path: strchr line splitting and a strncmp prefix chain
+static int classify_strncmp(const char* line) {
+    if (strncmp(line, "workspace>>", 11) == 0) return EVENT_WORKSPACE;
+    if (strncmp(line, "focusedmon>>", 12) == 0) return EVENT_FOCUSEDMON;
+    if (strncmp(line, "activespecial>>", 15) == 0) return EVENT_ACTIVESPECIAL;
+    if (strncmp(line, "openwindow>>", 12) == 0) return EVENT_OPENWINDOW;
+    if (strncmp(line, "closewindow>>", 13) == 0) return EVENT_CLOSEWINDOW;
+    if (strncmp(line, "movewindow>>", 12) == 0) return EVENT_MOVEWINDOW;
+    if (strncmp(line, "createworkspacev2>>", 19) == 0) return EVENT_CREATEWORKSPACE;
+    if (strncmp(line, "destroyworkspacev2>>", 20) == 0) return EVENT_DESTROYWORKSPACE;
+    if (strncmp(line, "moveworkspacev2>>", 17) == 0) return EVENT_MOVEWORKSPACE;
+    if (strncmp(line, "monitorremoved>>", 16) == 0) return EVENT_MONITORREMOVED;
+    if (strncmp(line, "windowtitlev2>>", 15) == 0) return EVENT_WINDOWTITLE;
+    if (strncmp(line, "urgent>>", 8) == 0) return EVENT_URGENT;
+    if (strncmp(line, "activewindowv2>>", 16) == 0) return EVENT_ACTIVEWINDOW;
+    if (strncmp(line, "fullscreen>>", 12) == 0) return EVENT_FULLSCREEN;
+    if (strncmp(line, "changefloatingmode>>", 20) == 0) return EVENT_CHANGEFLOATINGMODE;
+    return -1;
+}
+
+static ScanResult run_strchr(char* buf, size_t len) {
+    ScanResult r = { 0, 0, 0 };
+    char* line = buf;
+    char* next;
+
+    (void)len;
+    while ((next = strchr(line, '\n')) != NULL) {
+        *next = '\0';
+        r.lines++;
+        int type = classify_strncmp(line);
+        if (type >= 0) {
+            r.handled++;
+            r.checksum += (size_t)(type + 1) * (size_t)(strstr(line, ">>") - line);
+        }
+        *next = '\n';
+        line = next + 1;
+    }
+    return r;
+}
+
+static ScanResult run_scanner(char* buf, size_t len) {
+    ScanResult r = { 0, 0, 0 };
+    EventSpan spans[SCAN_SPANS];
+    size_t start = 0;
+    size_t count;
+
+    do {
+        size_t consumed;
+        count = event_scan_lines(buf + start, len - start, spans, SCAN_SPANS, &consumed);
+        for (size_t i = 0; i < count; i++) {
+            r.lines++;
+            if (spans[i].sep == EVENT_SCAN_NO_SEP) continue;
+            int type = event_classify(buf + start + spans[i].start, spans[i].sep);
+            if (type >= 0) {
+                r.handled++;
+                r.checksum += (size_t)(type + 1) * spans[i].sep;
+            }
+        }
+        start += consumed;
+    } while (count == SCAN_SPANS);
+    return r;
+}
+
+static int bench(const char* name, ScanResult (*run)(char*, size_t), char* buf, size_t len,
+                 int passes, const ScanResult* expect, ScanResult* out) {
+    ScanResult r = run(buf, len);  // Warm-up
+    double start = now_seconds();
+    for (int i = 0; i < passes; i++) {
+        r = run(buf, len);
+    }
+    double elapsed = now_seconds() - start;
+
+    double mb = (double)len * passes / (1024.0 * 1024.0);
+    printf("%-16s %8.1f MB/s %10.1f Mlines/s  (%zu lines, %zu handled)\n", name,
+           mb / elapsed, (double)r.lines * passes / elapsed / 1e6, r.lines, r.handled);
+
+    if (out) *out = r;
+    if (expect && (r.lines != expect->lines || r.handled != expect->handled ||
+                   r.checksum != expect->checksum)) {
+        fprintf(stderr, "%s: result differs from the strchr baseline\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s STREAM [MEGABYTES]\n", argv[0]);
+        return 2;
+    }
+    size_t target = (argc > 2 ? (size_t)atoi(argv[2]) : 8) * 1024 * 1024;
+
+    FILE* fp = fopen(argv[1], "rb");
+    if (!fp) {
+        perror(argv[1]);
+        return 2;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t stream_len = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    // Repeat the recording until the buffer is large enough to time
+    size_t copies = target / stream_len + 1;
+    size_t len = stream_len * copies;
+    char* buf = malloc(len + 1);
+    if (!buf || fread(buf, 1, stream_len, fp) != stream_len) {
+        fprintf(stderr, "Failed to read %s\n", argv[1]);
+        return 2;
+    }
+    fclose(fp);
+    for (size_t i = 1; i < copies; i++) {
+        memcpy(buf + i * stream_len, buf, stream_len);
+    }
+    buf[len] = '\0';
+
+    int passes = 20;
+    int failed = 0;
+    ScanResult baseline;
+    printf("Replaying %s: %zu KB x %zu copies, %d passes\n", argv[1], stream_len / 1024, copies, passes);
+
+    failed |= bench("strchr+strncmp", run_strchr, buf, len, passes, NULL, &baseline);
+
+    static const char* impls[] = { "scalar", "sse2", "avx2" };
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        if (event_scan_set_impl(impls[i]) < 0) {
+            printf("%-16s (not supported on this CPU)\n", impls[i]);
+            continue;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "scan/%s", impls[i]);
+        failed |= bench(name, run_scanner, buf, len, passes, &baseline, NULL);
+    }
+
+    free(buf);
+    return failed;
+}
@@ -0,0 +1,177 @@
+/**
+ * Render mode benchmark: widget tree vs. custom-drawn strip
+ *
+ * Builds COUNT workspace buttons in an offscreen window in each render mode
+ * and reports the heap held by the widgets, then moves the active workspace
+ * along the strip once per frame and times restyle + layout + paint.
+ * Needs a display (X11 or Wayland); without one it is skipped.
+ *
+ * Usage: bench_render [COUNT] [FRAMES]
+ */
+
+#include "workspace_button.h"
+#include "workspace_state.h"
+#include "workspace_strip.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DOT_COLOR "#adc8f8"
+
+typedef struct {
+    const char* name;
+    void* (*build)(GtkBox* box, int count);
+    void (*apply)(void* view, int count, int active);
+    void (*destroy)(void* view, int count);
+} BenchMode;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t heap_in_use(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static unsigned classes_for(int i, int active) {
+    unsigned classes = (i == active) ? WS_CLASS_ACTIVE : 0;
+    if (i % 3 == 2) classes |= WS_CLASS_EMPTY;
+    if (i % 5 == 4) classes |= WS_CLASS_HAS_SPECIAL;
+    return classes;
+}
+
+static void* build_buttons(GtkBox* box, int count) {
+    WorkspaceButton* buttons = calloc((size_t)count, sizeof(WorkspaceButton));
+    for (int i = 0; i < count; i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", i + 1);
+        workspace_button_init(&buttons[i], label, DOT_COLOR);
+        gtk_container_add(GTK_CONTAINER(box), GTK_WIDGET(buttons[i].button));
+    }
+    return buttons;
+}
+
+static void apply_buttons(void* view, int count, int active) {
+    WorkspaceButton* buttons = view;
+    for (int i = 0; i < count; i++) {
+        workspace_button_apply(&buttons[i], 1, classes_for(i, active));
+    }
+}
+
+static void destroy_buttons(void* view, int count) {
+    free(view);
+}
+
+static void* build_strip(GtkBox* box, int count) {
+    WorkspaceStrip* strip = calloc(1, sizeof(WorkspaceStrip));
+    workspace_strip_init(strip, count, DOT_COLOR, NULL, NULL);
+    for (int i = 0; i < count; i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", i + 1);
+        workspace_strip_set_slot(strip, i, i + 1, 1, 0, label);
+    }
+    gtk_container_add(GTK_CONTAINER(box), strip->area);
+    return strip;
+}
+
+static void apply_strip(void* view, int count, int active) {
+    WorkspaceStrip* strip = view;
+    for (int i = 0; i < count; i++) {
+        workspace_strip_set_slot(strip, i, i + 1, 1, classes_for(i, active), NULL);
+    }
+    workspace_strip_commit(strip);
+}
+
+static void destroy_strip(void* view, int count) {
+    workspace_strip_destroy(view);
+    free(view);
+}
+
+// Let GTK validate styles and sizes
+static void settle(void) {
+    while (gtk_events_pending()) {
+        gtk_main_iteration_do(FALSE);
+    }
+}
+
+// One frame: restyle and relayout, then paint the whole window
+static void run_frame(GtkWidget* window, cairo_surface_t* surface) {
+    settle();
+    cairo_t* cr = cairo_create(surface);
+    gtk_widget_draw(window, cr);
+    cairo_destroy(cr);
+}
+
+static void bench(const BenchMode* mode, int count, int frames, int report) {
+    size_t heap_before = heap_in_use();
+
+    GtkWidget* window = gtk_offscreen_window_new();
+    GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0));
+    gtk_widget_set_name(GTK_WIDGET(box), "workspaces");
+    gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(box));
+    void* view = mode->build(box, count);
+    gtk_widget_show_all(window);
+
+    mode->apply(view, count, 0);
+    settle();
+    GtkAllocation alloc;
+    gtk_widget_get_allocation(window, &alloc);
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                          alloc.width > 0 ? alloc.width : 1,
+                                                          alloc.height > 0 ? alloc.height : 1);
+    run_frame(window, surface);
+    size_t heap = heap_in_use() - heap_before;
+
+    double start = now_seconds();
+    for (int f = 1; f <= frames; f++) {
+        mode->apply(view, count, f % count);
+        run_frame(window, surface);
+    }
+    double elapsed = now_seconds() - start;
+
+    if (report) {
+        printf("%-8s %4d workspaces: %8.1f KB heap %8.1f us/frame\n", mode->name, count,
+               heap / 1024.0, elapsed / frames * 1e6);
+    }
+
+    cairo_surface_destroy(surface);
+    mode->destroy(view, count);
+    gtk_widget_destroy(window);
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 50;
+    int frames = argc > 2 ? atoi(argv[2]) : 500;
+
+    if (count < 1 || frames < 1) {
+        fprintf(stderr, "Usage: %s [COUNT] [FRAMES]\n", argv[0]);
+        return 2;
+    }
+    if (!gtk_init_check(&argc, &argv)) {
+        fprintf(stderr, "No display, skipping\n");
+        return 77;
+    }
+
+    static const BenchMode modes[] = {
+        { "buttons", build_buttons, apply_buttons, destroy_buttons },
+        { "strip", build_strip, apply_strip, destroy_strip },
+    };
+    size_t mode_count = sizeof(modes) / sizeof(modes[0]);
+
+    // Warm-up: theme, CSS and font caches are loaded once per process and
+    // would otherwise be charged to whichever mode runs first
+    for (size_t i = 0; i < mode_count; i++) {
+        bench(&modes[i], 1, 1, 0);
+    }
+    for (size_t i = 0; i < mode_count; i++) {
+        bench(&modes[i], count, frames, 1);
+    }
+    return 0;
+}
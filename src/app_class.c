@@ -0,0 +1,63 @@
+/**
+ * Window class table - see app_class.h
+ */
+
+#include "app_class.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#define INDEX_SIZE (APP_CLASS_MAX * 2)   // Power of two, at most half full
+
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+static char names[APP_CLASS_MAX + 1][APP_CLASS_NAME_MAX];  // [0] stays ""
+static AppClassId name_index[INDEX_SIZE];                  // Open addressing, 0 = empty
+static atomic_int class_count;
+
+// FNV-1a
+static size_t name_hash(const char* name, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash & (INDEX_SIZE - 1);
+}
+
+AppClassId app_class_intern(const char* name, size_t len) {
+    if (len == 0) return 0;
+    if (len >= APP_CLASS_NAME_MAX) len = APP_CLASS_NAME_MAX - 1;
+
+    AppClassId id = 0;
+    pthread_mutex_lock(&table_lock);
+    for (size_t i = name_hash(name, len);; i = (i + 1) & (INDEX_SIZE - 1)) {
+        AppClassId candidate = name_index[i];
+        if (candidate == 0) {
+            // New class: append it unless the table is full
+            int count = atomic_load_explicit(&class_count, memory_order_relaxed);
+            if (count < APP_CLASS_MAX) {
+                id = (AppClassId)(count + 1);
+                memcpy(names[id], name, len);
+                names[id][len] = '\0';
+                name_index[i] = id;
+                atomic_store_explicit(&class_count, count + 1, memory_order_release);
+            }
+            break;
+        }
+        if (strncmp(names[candidate], name, len) == 0 && names[candidate][len] == '\0') {
+            id = candidate;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&table_lock);
+    return id;
+}
+
+const char* app_class_name(AppClassId id) {
+    return id <= APP_CLASS_MAX ? names[id] : names[0];
+}
+
+int app_class_count(void) {
+    return atomic_load_explicit(&class_count, memory_order_acquire);
+}
@@ -0,0 +1,32 @@
+/**
+ * Process-wide table of window classes ("firefox", "org.gnome.Nautilus").
+ *
+ * Windows carry a small AppClassId instead of their class string, so the
+ * window table and render state stay fixed-size. Every bar instance in the
+ * process shares the table, which is what lets the icon cache be keyed by
+ * id. Classes are never removed; the table is bounded and new classes past
+ * the bound get id 0 (no icon).
+ *
+ * Interning takes a mutex and never allocates. Names can be read from any
+ * thread for ids that reached it through a synchronised path (the worker's
+ * published render, for the UI).
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define APP_CLASS_MAX 512
+#define APP_CLASS_NAME_MAX 64
+
+typedef unsigned short AppClassId;   // 0: unknown class
+
+// Id of the class spelled name[0, len), adding it if new. 0 for an empty
+// name or a full table; names longer than the limit are truncated.
+AppClassId app_class_intern(const char* name, size_t len);
+
+// Class name of an id returned by app_class_intern() ("" for 0)
+const char* app_class_name(AppClassId id);
+
+// Classes interned so far
+int app_class_count(void);
@@ -0,0 +1,95 @@
+/**
+ * Shared app icon cache - see app_icons.h
+ */
+
+#include "app_icons.h"
+#include <string.h>
+
+typedef struct {
+    AppClassId app;
+    int size;
+    int scale;
+    cairo_surface_t* surface;    // NULL: the theme has no icon for the class
+    unsigned long last_used;     // 0: free entry
+} IconEntry;
+
+static IconEntry entries[APP_ICON_CACHE_SIZE];
+static unsigned long use_clock;
+static unsigned generation;
+static AppIconStats stats;
+static GtkIconTheme* theme;
+
+static void flush(void) {
+    for (int i = 0; i < APP_ICON_CACHE_SIZE; i++) {
+        if (entries[i].surface) cairo_surface_destroy(entries[i].surface);
+    }
+    memset(entries, 0, sizeof(entries));
+    generation++;
+}
+
+static void on_theme_changed(GtkIconTheme* changed, gpointer user_data) {
+    flush();
+}
+
+// Classes are usually icon names already ("firefox", "org.gnome.Nautilus"),
+// sometimes only in a different case ("Slack")
+static cairo_surface_t* load_icon(const char* name, int size, int scale) {
+    char lower[APP_CLASS_NAME_MAX];
+    size_t len = strlen(name);
+    for (size_t i = 0; i <= len; i++) {
+        lower[i] = g_ascii_tolower(name[i]);
+    }
+
+    const char* candidates[] = { name, lower };
+    size_t count = strcmp(name, lower) == 0 ? 1 : 2;
+    for (size_t i = 0; i < count; i++) {
+        GtkIconInfo* info = gtk_icon_theme_lookup_icon_for_scale(
+            theme, candidates[i], size, scale, GTK_ICON_LOOKUP_FORCE_SIZE);
+        if (!info) continue;
+        cairo_surface_t* surface = gtk_icon_info_load_surface(info, NULL, NULL);
+        g_object_unref(info);
+        if (surface) return surface;
+    }
+    return NULL;
+}
+
+cairo_surface_t* app_icon_get(AppClassId app, int size, int scale) {
+    if (app == 0) return NULL;
+    if (!theme) {
+        theme = gtk_icon_theme_get_default();
+        g_signal_connect(theme, "changed", G_CALLBACK(on_theme_changed), NULL);
+    }
+    stats.requests++;
+    use_clock++;
+
+    IconEntry* victim = &entries[0];
+    for (int i = 0; i < APP_ICON_CACHE_SIZE; i++) {
+        IconEntry* entry = &entries[i];
+        if (entry->last_used && entry->app == app && entry->size == size && entry->scale == scale) {
+            entry->last_used = use_clock;
+            return entry->surface;
+        }
+        if (entry->last_used < victim->last_used) victim = entry;
+    }
+
+    // Miss: reuse a free entry or the least recently used one
+    if (victim->last_used) {
+        if (victim->surface) cairo_surface_destroy(victim->surface);
+        stats.evictions++;
+    }
+    stats.theme_lookups++;
+    victim->app = app;
+    victim->size = size;
+    victim->scale = scale;
+    victim->surface = load_icon(app_class_name(app), size, scale);
+    victim->last_used = use_clock;
+    return victim->surface;
+}
+
+unsigned app_icon_generation(void) {
+    return generation;
+}
+
+const AppIconStats* app_icon_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,34 @@
+/**
+ * App icons for window classes, shared by every bar in the process.
+ *
+ * A class is resolved through the default GtkIconTheme once per size and
+ * scale; the loaded surface (or the fact that the theme has none) goes into
+ * a fixed-size LRU cache. A window opening on a class that was seen before
+ * therefore costs no icon-theme lookup. An icon theme change flushes the
+ * cache and bumps the generation, so callers know to look up again.
+ *
+ * GTK main thread only.
+ */
+
+#pragma once
+
+#include "app_class.h"
+#include <gtk/gtk.h>
+
+#define APP_ICON_CACHE_SIZE 128
+
+typedef struct {
+    unsigned long requests;     // app_icon_get() calls
+    unsigned long theme_lookups; // Cache misses resolved through the icon theme
+    unsigned long evictions;
+} AppIconStats;
+
+// Icon of class app at size x size logical pixels and the given scale, or
+// NULL if the theme has none. Borrowed from the cache: widgets showing it
+// must hold their own reference.
+cairo_surface_t* app_icon_get(AppClassId app, int size, int scale);
+
+// Changes whenever surfaces handed out so far may be stale (theme change)
+unsigned app_icon_generation(void);
+
+const AppIconStats* app_icon_stats(void);
@@ -0,0 +1,69 @@
+/**
+ * Bump arena - see arena.h
+ */
+
+#include "arena.h"
+#include <stdint.h>
+#include <sys/mman.h>
+
+#define ARENA_ALIGN 16
+
+// Bytes kept resident across resets; typical replies fit in this
+#define ARENA_KEEP_RESIDENT (64 * 1024)
+
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+int arena_init(Arena* arena, size_t capacity) {
+    arena->base = mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    arena->capacity = capacity;
+    arena->used = 0;
+    arena->high_water = 0;
+    if (arena->base == MAP_FAILED) {
+        arena->base = NULL;
+        arena->capacity = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void arena_destroy(Arena* arena) {
+    if (arena->base) {
+        munmap(arena->base, arena->capacity);
+    }
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+void arena_reset(Arena* arena) {
+    if (arena->used > ARENA_KEEP_RESIDENT && arena->capacity > ARENA_KEEP_RESIDENT) {
+        madvise(arena->base + ARENA_KEEP_RESIDENT, arena->capacity - ARENA_KEEP_RESIDENT,
+                MADV_DONTNEED);
+    }
+    arena->used = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size_t start = align_up(arena->used);
+    if (start > arena->capacity || size > arena->capacity - start) {
+        return NULL;
+    }
+    arena->used = start + size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return arena->base + start;
+}
+
+char* arena_peek(Arena* arena, size_t* avail) {
+    size_t start = align_up(arena->used);
+    if (start >= arena->capacity) {
+        *avail = 0;
+        return NULL;
+    }
+    *avail = arena->capacity - start;
+    return arena->base + start;
+}
@@ -0,0 +1,34 @@
+/**
+ * Bump arena for per-query scratch memory.
+ *
+ * hyprctl replies and the structures parsed from them live only for the
+ * duration of one query, so they are bump-allocated from a fixed region and
+ * dropped all at once with arena_reset(). The region is reserved up front and
+ * only touched pages become resident, so the bound costs nothing until used.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+typedef struct {
+    char* base;
+    size_t capacity;
+    size_t used;
+    size_t high_water;  // Largest `used` seen, for stats and page release
+} Arena;
+
+// Reserve capacity bytes. Returns -1 if the mapping fails.
+int arena_init(Arena* arena, size_t capacity);
+void arena_destroy(Arena* arena);
+
+// Drop every allocation. Pages beyond the first few are handed back to the
+// kernel, so one oversized reply doesn't stay resident for the process lifetime.
+void arena_reset(Arena* arena);
+
+// Allocate size bytes (16-byte aligned), or NULL if the arena is full
+void* arena_alloc(Arena* arena, size_t size);
+
+// Free space at the top of the arena, for reading data of unknown length.
+// Claim what was written with arena_alloc(); the pointer stays the same.
+char* arena_peek(Arena* arena, size_t* avail);
@@ -0,0 +1,51 @@
+/**
+ * Shared blink timer - see blink_timer.h
+ */
+
+#include "blink_timer.h"
+
+static BlinkSubscriber* subscribers;
+static guint source;
+static int phase;
+
+static gboolean on_blink_tick(gpointer user_data) {
+    phase = !phase;
+    // Callbacks may unsubscribe themselves
+    for (BlinkSubscriber* sub = subscribers, *next; sub; sub = next) {
+        next = sub->next;
+        sub->func(phase, sub->user_data);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+void blink_timer_subscribe(BlinkSubscriber* sub) {
+    if (sub->subscribed) return;
+    sub->subscribed = 1;
+    sub->next = subscribers;
+    subscribers = sub;
+    if (!source) {
+        phase = 1;
+        source = g_timeout_add(BLINK_INTERVAL_MS, on_blink_tick, NULL);
+    }
+}
+
+void blink_timer_unsubscribe(BlinkSubscriber* sub) {
+    if (!sub->subscribed) return;
+    for (BlinkSubscriber** link = &subscribers; *link; link = &(*link)->next) {
+        if (*link == sub) {
+            *link = sub->next;
+            break;
+        }
+    }
+    sub->subscribed = 0;
+    sub->next = NULL;
+    if (!subscribers && source) {
+        g_source_remove(source);
+        source = 0;
+        phase = 0;
+    }
+}
+
+int blink_timer_phase(void) {
+    return phase;
+}
@@ -0,0 +1,40 @@
+/**
+ * One blink timer shared by every bar in the process.
+ *
+ * Modules with something blinking (urgent workspaces) subscribe. While
+ * anyone is subscribed, a single GLib timeout flips a process-wide phase and
+ * calls each subscriber, so every blinking button on every bar changes in
+ * step and no button owns a source. The timeout is removed as soon as the
+ * last subscriber leaves.
+ *
+ * Subscribers are linked through the structs they embed, so subscribing
+ * never allocates.
+ *
+ * GTK main thread only.
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+#define BLINK_INTERVAL_MS 500
+
+// Called on every phase flip with the new phase (1: on, 0: off)
+typedef void (*BlinkFunc)(int phase, void* user_data);
+
+typedef struct BlinkSubscriber {
+    BlinkFunc func;
+    void* user_data;
+    int subscribed;
+    struct BlinkSubscriber* next;
+} BlinkSubscriber;
+
+// Start receiving phase flips; no-op if already subscribed. The first
+// subscriber starts the timer in the "on" phase.
+void blink_timer_subscribe(BlinkSubscriber* sub);
+
+// Stop receiving them (safe from inside a callback); no-op if not subscribed
+void blink_timer_unsubscribe(BlinkSubscriber* sub);
+
+// Current phase, 0 while nobody is subscribed
+int blink_timer_phase(void);
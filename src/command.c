@@ -0,0 +1,58 @@
+/**
+ * Command helpers - see command.h
+ */
+
+#include "command.h"
+#include <stdio.h>
+#include <string.h>
+
+void popen_string(const char* cmd, char* output, size_t output_size) {
+    FILE* fp = popen(cmd, "r");
+    if (!fp) {
+        output[0] = '\0';
+        return;
+    }
+    if (fgets(output, output_size, fp) == NULL) {
+        output[0] = '\0';
+    }
+    // Remove trailing newline
+    size_t len = strlen(output);
+    if (len > 0 && output[len-1] == '\n') {
+        output[len-1] = '\0';
+    }
+    pclose(fp);
+}
+
+int popen_int(const char* cmd) {
+    FILE* fp = popen(cmd, "r");
+    if (!fp) return 0;
+
+    int result = 0;
+    if (fscanf(fp, "%d", &result) != 1) {
+        result = 0;
+    }
+    pclose(fp);
+    return result;
+}
+
+const char* read_command_output(Arena* arena, const char* cmd) {
+    size_t avail;
+    char* buffer = arena_peek(arena, &avail);
+    if (!buffer || avail < 2) return NULL;
+
+    FILE* fp = popen(cmd, "r");
+    if (!fp) return NULL;
+
+    size_t total = 0;
+    size_t bytes;
+    while (total < avail - 1 &&
+           (bytes = fread(buffer + total, 1, avail - total - 1, fp)) > 0) {
+        total += bytes;
+    }
+    pclose(fp);
+    if (total == 0) return NULL;
+
+    buffer[total] = '\0';
+    arena_alloc(arena, total + 1);
+    return buffer;
+}
@@ -0,0 +1,18 @@
+/**
+ * Helpers for running hyprctl (and other) commands through popen().
+ */
+
+#pragma once
+
+#include "arena.h"
+#include <stddef.h>
+
+// First line of the command's output, without the newline ("" on failure)
+void popen_string(const char* cmd, char* output, size_t output_size);
+
+// Leading integer of the command's output (0 on failure)
+int popen_int(const char* cmd);
+
+// Entire output read into the arena (NUL-terminated), or NULL if the command
+// produced nothing. Output that doesn't fit is truncated.
+const char* read_command_output(Arena* arena, const char* cmd);
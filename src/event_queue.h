@@ -0,0 +1,184 @@
+/**
+ * Parsed Hyprland events and a lock-free single-producer/single-consumer
+ * queue carrying them from the socket reader thread to the state worker.
+ *
+ * The reader only drains socket2 and pushes events; it never blocks on a
+ * hyprctl query, so Hyprland never has to buffer events for us.
+ *
+ * Title changes can arrive by the thousand per second (a terminal or browser
+ * rewriting its title), enough to fill the queue while the worker is busy
+ * with a resync. Rather than count as an overflow, which would cost another
+ * resync, events that don't fit are parked on the producer side and go into
+ * the queue ahead of anything else once there is room. Parked titles keep
+ * only the newest per window; runs of workspace>>, fullscreen>> or
+ * activespecial>> only the last of the run.
+ */
+
+#pragma once
+
+#include "event_scan.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Must be a power of two. Sized for the events of a flood during one resync's queries.
+#define EVENT_QUEUE_CAPACITY 1024
+#define EVENT_PAYLOAD_MAX 256      // Longer payloads (window titles) are truncated
+#define EVENT_PARKED_MAX 64        // Events that can wait out a full queue
+
+typedef struct {
+    HyprEventType type;
+    char payload[EVENT_PAYLOAD_MAX];  // Data after ">>", NUL-terminated
+} HyprEvent;
+
+typedef struct {
+    _Alignas(64) _Atomic size_t head;  // Next slot to fill (written by producer)
+    _Alignas(64) _Atomic size_t tail;  // Next slot to drain (written by consumer)
+    _Atomic size_t high_water;         // Deepest observed backlog (written by producer)
+    _Atomic unsigned long dropped;     // Events lost to a full queue (written by producer)
+    _Atomic unsigned long coalesced;   // Parked events replaced by a newer one (written by producer)
+    HyprEvent slots[EVENT_QUEUE_CAPACITY];
+
+    // Producer only: events waiting for room, in arrival order
+    HyprEvent parked[EVENT_PARKED_MAX];
+    size_t parked_count;
+} EventQueue;
+
+// Producer: slot to fill in place, or NULL if the queue is full
+static inline HyprEvent* event_queue_reserve(EventQueue* q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail == EVENT_QUEUE_CAPACITY) return NULL;
+    return &q->slots[head & (EVENT_QUEUE_CAPACITY - 1)];
+}
+
+// Consumer: drop everything queued so far
+static inline void event_queue_discard(EventQueue* q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    atomic_store_explicit(&q->tail, head, memory_order_release);
+}
+
+// Producer: publish the slot returned by event_queue_reserve()
+static inline void event_queue_commit(EventQueue* q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed) + 1;
+    atomic_store_explicit(&q->head, head, memory_order_release);
+
+    size_t depth = head - atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (depth > atomic_load_explicit(&q->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&q->high_water, depth, memory_order_relaxed);
+    }
+}
+
+// Consumer: oldest queued event, or NULL if empty
+static inline const HyprEvent* event_queue_peek(EventQueue* q) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) return NULL;
+    return &q->slots[tail & (EVENT_QUEUE_CAPACITY - 1)];
+}
+
+// Consumer: release the slot returned by event_queue_peek()
+static inline void event_queue_pop(EventQueue* q) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+}
+
+static inline void event_set(HyprEvent* event, int type, const char* payload, size_t len) {
+    if (len >= sizeof(event->payload)) len = sizeof(event->payload) - 1;
+    event->type = (HyprEventType)type;
+    memcpy(event->payload, payload, len);
+    event->payload[len] = '\0';
+}
+
+// Producer: move parked events into the queue, oldest first.
+// Returns the number still parked.
+static inline size_t event_queue_flush_parked(EventQueue* q) {
+    size_t moved = 0;
+    while (moved < q->parked_count) {
+        HyprEvent* event = event_queue_reserve(q);
+        if (!event) break;
+        *event = q->parked[moved++];
+        event_queue_commit(q);
+    }
+    q->parked_count -= moved;
+    memmove(q->parked, q->parked + moved, q->parked_count * sizeof(HyprEvent));
+    return q->parked_count;
+}
+
+// Parked event of type that a newer one of the same type may replace, or NULL
+static inline HyprEvent* event_queue_parked_match(EventQueue* q, int type, const char* payload,
+                                                  size_t len) {
+    HyprEvent* last = q->parked_count ? &q->parked[q->parked_count - 1] : NULL;
+    switch (type) {
+    case EVENT_WINDOWTITLE: {
+        // windowtitlev2>>ADDRESS,TITLE: only the newest title of a window matters
+        const char* comma = memchr(payload, ',', len);
+        size_t address_len = comma ? (size_t)(comma - payload) + 1 : len;
+        for (size_t i = 0; i < q->parked_count; i++) {
+            if (q->parked[i].type == EVENT_WINDOWTITLE &&
+                strncmp(q->parked[i].payload, payload, address_len) == 0) {
+                return &q->parked[i];
+            }
+        }
+        return NULL;
+    }
+    case EVENT_WORKSPACE:
+    case EVENT_FULLSCREEN:
+    case EVENT_ACTIVESPECIAL:
+        // Focus (or the focused window's fullscreen state) moved on before
+        // the worker saw it: only where it ended up matters
+        return last && last->type == (HyprEventType)type ? last : NULL;
+    default:
+        return NULL;
+    }
+}
+
+// Producer: park an event that didn't fit behind those already parked, or
+// coalesce it with one it supersedes. Returns 0, or -1 if full.
+static inline int event_queue_park(EventQueue* q, int type, const char* payload, size_t len) {
+    HyprEvent* match = event_queue_parked_match(q, type, payload, len);
+    if (match) {
+        event_set(match, type, payload, len);
+        atomic_fetch_add_explicit(&q->coalesced, 1, memory_order_relaxed);
+        return 0;
+    }
+    if (q->parked_count == EVENT_PARKED_MAX) return -1;
+    event_set(&q->parked[q->parked_count++], type, payload, len);
+    return 0;
+}
+
+// Producer: classify one scanned line and queue it, behind any parked events.
+// Returns 1 if queued, 0 if the event is ignored or parked, -1 if it was
+// dropped (parked events go with it: the consumer must resync).
+static inline int event_queue_push_line(EventQueue* q, const char* line, const EventSpan* span) {
+    if (span->sep == EVENT_SCAN_NO_SEP) return 0;
+
+    int type = event_classify(line, span->sep);
+    if (type < 0) return 0;
+
+    const char* payload = line + span->sep + 2;
+    size_t payload_len = span->len - span->sep - 2;
+    HyprEvent* event = NULL;
+    if (q->parked_count == 0 || event_queue_flush_parked(q) == 0) {
+        event = event_queue_reserve(q);
+    }
+    if (!event) {
+        if (event_queue_park(q, type, payload, payload_len) == 0) {
+            return 0;
+        }
+        atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+        q->parked_count = 0;
+        return -1;
+    }
+
+    event_set(event, type, payload, payload_len);
+    event_queue_commit(q);
+    return 1;
+}
+
+// Current backlog (approximate when read from a third thread)
+static inline size_t event_queue_depth(EventQueue* q) {
+    return atomic_load_explicit(&q->head, memory_order_relaxed) -
+           atomic_load_explicit(&q->tail, memory_order_relaxed);
+}
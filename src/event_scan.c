@@ -0,0 +1,200 @@
+/**
+ * Event line scanner - see event_scan.h
+ *
+ * Every implementation walks the buffer once, turning each block into a
+ * bitmask of newlines and ">>" starts, then visits the set bits in order.
+ * The scalar loop handles the tail that doesn't fill a whole block.
+ */
+
+#include "event_scan.h"
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define EVENT_SCAN_X86 1
+#endif
+
+typedef struct {
+    EventSpan* spans;
+    size_t max_spans;
+    size_t count;
+    size_t line_start;
+    size_t sep;  // Absolute offset of the current line's first ">>", or SIZE_MAX
+} ScanState;
+
+typedef void (*ScanFunc)(const char* buf, size_t len, ScanState* st);
+
+// Record a line ending at pos. Returns 0 once the span array is full.
+static inline int scan_newline(ScanState* st, size_t pos) {
+    EventSpan* span = &st->spans[st->count++];
+    span->start = (uint32_t)st->line_start;
+    span->len = (uint32_t)(pos - st->line_start);
+    span->sep = st->sep == SIZE_MAX ? EVENT_SCAN_NO_SEP : (uint32_t)(st->sep - st->line_start);
+    st->line_start = pos + 1;
+    st->sep = SIZE_MAX;
+    return st->count < st->max_spans;
+}
+
+// Visit newline/separator bits of one block at base. Returns 0 when full.
+static inline int scan_mask(const char* buf, ScanState* st, size_t base, uint32_t mask) {
+    while (mask) {
+        size_t pos = base + (size_t)__builtin_ctz(mask);
+        if (buf[pos] == '\n') {
+            if (!scan_newline(st, pos)) return 0;
+        } else if (st->sep == SIZE_MAX) {
+            st->sep = pos;
+        }
+        mask &= mask - 1;
+    }
+    return 1;
+}
+
+// Scalar scan of buf[from, len)
+static void scan_tail(const char* buf, size_t from, size_t len, ScanState* st) {
+    for (size_t pos = from; pos < len; pos++) {
+        if (buf[pos] == '\n') {
+            if (!scan_newline(st, pos)) return;
+        } else if (buf[pos] == '>' && pos + 1 < len && buf[pos + 1] == '>' && st->sep == SIZE_MAX) {
+            st->sep = pos;
+        }
+    }
+}
+
+static void scan_scalar(const char* buf, size_t len, ScanState* st) {
+    scan_tail(buf, 0, len, st);
+}
+
+#ifdef EVENT_SCAN_X86
+// ">>" starts are found by comparing the block and the block shifted by one
+// byte; blocks stop one byte early so the shifted load stays in bounds.
+static void scan_sse2(const char* buf, size_t len, ScanState* st) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i gt = _mm_set1_epi8('>');
+    size_t pos = 0;
+
+    for (; pos + 17 <= len; pos += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(buf + pos));
+        __m128i next = _mm_loadu_si128((const __m128i*)(buf + pos + 1));
+        __m128i sep = _mm_and_si128(_mm_cmpeq_epi8(block, gt), _mm_cmpeq_epi8(next, gt));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, newline), sep));
+        if (mask && !scan_mask(buf, st, pos, mask)) return;
+    }
+    scan_tail(buf, pos, len, st);
+}
+
+__attribute__((target("avx2")))
+static void scan_avx2(const char* buf, size_t len, ScanState* st) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i gt = _mm256_set1_epi8('>');
+    size_t pos = 0;
+
+    for (; pos + 33 <= len; pos += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(buf + pos));
+        __m256i next = _mm256_loadu_si256((const __m256i*)(buf + pos + 1));
+        __m256i sep = _mm256_and_si256(_mm256_cmpeq_epi8(block, gt), _mm256_cmpeq_epi8(next, gt));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, newline), sep));
+        if (mask && !scan_mask(buf, st, pos, mask)) return;
+    }
+    scan_tail(buf, pos, len, st);
+}
+#endif
+
+static ScanFunc scan_impl = scan_scalar;
+static const char* scan_impl_name = "scalar";
+
+// Pick the widest implementation once, at load time
+__attribute__((constructor))
+static void event_scan_init(void) {
+#ifdef EVENT_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scan_impl = scan_avx2;
+        scan_impl_name = "avx2";
+    } else {
+        scan_impl = scan_sse2;
+        scan_impl_name = "sse2";
+    }
+#endif
+}
+
+size_t event_scan_lines(const char* buf, size_t len, EventSpan* spans, size_t max_spans,
+                        size_t* consumed) {
+    ScanState st = {
+        .spans = spans,
+        .max_spans = max_spans,
+        .count = 0,
+        .line_start = 0,
+        .sep = SIZE_MAX,
+    };
+
+    if (max_spans > 0) {
+        scan_impl(buf, len, &st);
+    }
+    *consumed = st.line_start;
+    return st.count;
+}
+
+int event_classify(const char* name, size_t len) {
+    // Dispatch on length first so most names cost a single memcmp
+    switch (len) {
+    case 6:
+        if (memcmp(name, "urgent", 6) == 0) return EVENT_URGENT;
+        break;
+    case 9:
+        if (memcmp(name, "workspace", 9) == 0) return EVENT_WORKSPACE;
+        break;
+    case 10:
+        if (memcmp(name, "focusedmon", 10) == 0) return EVENT_FOCUSEDMON;
+        if (memcmp(name, "fullscreen", 10) == 0) return EVENT_FULLSCREEN;
+        if (memcmp(name, "openwindow", 10) == 0) return EVENT_OPENWINDOW;
+        if (memcmp(name, "movewindow", 10) == 0) return EVENT_MOVEWINDOW;
+        break;
+    case 11:
+        if (memcmp(name, "closewindow", 11) == 0) return EVENT_CLOSEWINDOW;
+        break;
+    case 13:
+        if (memcmp(name, "activespecial", 13) == 0) return EVENT_ACTIVESPECIAL;
+        if (memcmp(name, "windowtitlev2", 13) == 0) return EVENT_WINDOWTITLE;
+        break;
+    case 14:
+        if (memcmp(name, "monitorremoved", 14) == 0) return EVENT_MONITORREMOVED;
+        if (memcmp(name, "activewindowv2", 14) == 0) return EVENT_ACTIVEWINDOW;
+        break;
+    case 15:
+        if (memcmp(name, "moveworkspacev2", 15) == 0) return EVENT_MOVEWORKSPACE;
+        break;
+    case 17:
+        if (memcmp(name, "createworkspacev2", 17) == 0) return EVENT_CREATEWORKSPACE;
+        break;
+    case 18:
+        if (memcmp(name, "destroyworkspacev2", 18) == 0) return EVENT_DESTROYWORKSPACE;
+        if (memcmp(name, "changefloatingmode", 18) == 0) return EVENT_CHANGEFLOATINGMODE;
+        break;
+    }
+    return -1;
+}
+
+const char* event_scan_impl(void) {
+    return scan_impl_name;
+}
+
+int event_scan_set_impl(const char* name) {
+    if (strcmp(name, "scalar") == 0) {
+        scan_impl = scan_scalar;
+        scan_impl_name = "scalar";
+        return 0;
+    }
+#ifdef EVENT_SCAN_X86
+    if (strcmp(name, "sse2") == 0) {
+        scan_impl = scan_sse2;
+        scan_impl_name = "sse2";
+        return 0;
+    }
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        scan_impl = scan_avx2;
+        scan_impl_name = "avx2";
+        return 0;
+    }
+#endif
+    return -1;
+}
@@ -0,0 +1,56 @@
+/**
+ * Event line scanner for Hyprland's socket2 stream.
+ *
+ * Finds line boundaries and the ">>" name/payload separator in a single
+ * pass, using AVX2 or SSE2 when the CPU supports them (selected at load
+ * time) and a scalar loop otherwise.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVENT_SCAN_NO_SEP UINT32_MAX
+
+// Events the module reacts to; everything else is dropped by the reader
+typedef enum {
+    EVENT_WORKSPACE,           // workspace>>NAME
+    EVENT_FOCUSEDMON,          // focusedmon>>MONITOR,WORKSPACE
+    EVENT_ACTIVESPECIAL,       // activespecial>>WORKSPACE,MONITOR
+    EVENT_OPENWINDOW,          // openwindow>>ADDRESS,WORKSPACE,CLASS,TITLE
+    EVENT_CLOSEWINDOW,         // closewindow>>ADDRESS
+    EVENT_MOVEWINDOW,          // movewindow>>ADDRESS,WORKSPACE
+    EVENT_CREATEWORKSPACE,     // createworkspacev2>>ID,NAME
+    EVENT_DESTROYWORKSPACE,    // destroyworkspacev2>>ID,NAME
+    EVENT_MOVEWORKSPACE,       // moveworkspacev2>>ID,NAME,MONITOR
+    EVENT_MONITORREMOVED,      // monitorremoved>>MONITOR
+    EVENT_WINDOWTITLE,         // windowtitlev2>>ADDRESS,TITLE
+    EVENT_URGENT,              // urgent>>ADDRESS
+    EVENT_ACTIVEWINDOW,        // activewindowv2>>ADDRESS
+    EVENT_FULLSCREEN,          // fullscreen>>0|1
+    EVENT_CHANGEFLOATINGMODE,  // changefloatingmode>>ADDRESS,0|1
+} HyprEventType;
+
+// One complete event line in a scanned buffer
+typedef struct {
+    uint32_t start;  // Offset of the line in the buffer
+    uint32_t len;    // Line length, excluding the newline
+    uint32_t sep;    // Offset of ">>" within the line, or EVENT_SCAN_NO_SEP
+} EventSpan;
+
+// Scan buf[0, len) for complete ('\n'-terminated) lines, filling at most
+// max_spans spans. Returns the number of spans; *consumed is set to the
+// offset just past the last newline reported.
+size_t event_scan_lines(const char* buf, size_t len, EventSpan* spans, size_t max_spans,
+                        size_t* consumed);
+
+// Map an event name (the text before ">>") to a HyprEventType, or -1 for
+// events the module ignores
+int event_classify(const char* name, size_t len);
+
+// Name of the active scanner implementation: "avx2", "sse2" or "scalar"
+const char* event_scan_impl(void);
+
+// Force an implementation (benchmarks/tests). Returns -1 if unsupported here.
+int event_scan_set_impl(const char* name);
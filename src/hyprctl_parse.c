@@ -0,0 +1,283 @@
+/**
+ * Parsers for hyprctl JSON replies - see hyprctl_parse.h
+ *
+ * A minimal walker rather than a JSON library: replies are only scanned for
+ * the few keys the module needs, and nothing is allocated.
+ */
+
+#include "hyprctl_parse.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Minimal JSON helpers for hyprctl replies. Each returns a pointer past the
+// parsed element, or NULL on malformed/truncated input.
+static const char* json_skip_ws(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    return p;
+}
+
+static const char* json_skip_string(const char* p) {
+    if (*p != '"') return NULL;
+    for (p++; *p; p++) {
+        if (*p == '\\') {
+            if (!*++p) return NULL;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return NULL;
+}
+
+static const char* json_skip_value(const char* p) {
+    if (*p == '"') return json_skip_string(p);
+
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        while (*p) {
+            if (*p == '"') {
+                p = json_skip_string(p);
+                if (!p) return NULL;
+                continue;
+            }
+            if (*p == '{' || *p == '[') depth++;
+            if (*p == '}' || *p == ']') {
+                if (--depth == 0) return p + 1;
+            }
+            p++;
+        }
+        return NULL;
+    }
+
+    // Number, true, false, null
+    const char* start = p;
+    while (*p && *p != ',' && *p != '}' && *p != ']' &&
+           *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+    return (p == start || !*p) ? NULL : p;
+}
+
+// Copy a JSON string value (escapes are kept verbatim - names never contain them)
+static void json_copy_string(const char* p, char* dest, size_t dest_size) {
+    size_t i = 0;
+    if (*p == '"') {
+        for (p++; *p && *p != '"' && i < dest_size - 1; p++) {
+            dest[i++] = *p;
+        }
+    }
+    dest[i] = '\0';
+}
+
+// Copy a JSON string value that may carry escapes (window titles). Simple
+// escapes are decoded; \uXXXX, which Hyprland only emits for control
+// characters, is dropped.
+static void json_copy_text(const char* p, char* dest, size_t dest_size) {
+    size_t i = 0;
+    if (*p == '"') {
+        for (p++; *p && *p != '"' && i < dest_size - 1; p++) {
+            if (*p != '\\') {
+                dest[i++] = *p;
+                continue;
+            }
+            p++;
+            if (*p == 'u') {
+                for (int k = 0; k < 4 && p[1]; k++) p++;
+            } else if (*p == '"' || *p == '\\' || *p == '/') {
+                dest[i++] = *p;
+            } else if (*p) {
+                dest[i++] = ' ';   // \n, \t, ...
+            } else {
+                break;
+            }
+        }
+    }
+    // Never end on a partial UTF-8 sequence
+    if (i == dest_size - 1) {
+        while (i > 0 && ((unsigned char)dest[i - 1] & 0xC0) == 0x80) i--;
+        if (i > 0 && ((unsigned char)dest[i - 1] & 0xC0) == 0xC0) i--;
+    }
+    dest[i] = '\0';
+}
+
+static int json_key_is(const char* key, size_t key_len, const char* name) {
+    return strlen(name) == key_len && memcmp(key, name, key_len) == 0;
+}
+
+// Parse `hyprctl workspaces -j` into snap. Every workspace, special ones
+// included, carries its window count and monitor, so counts never need the much
+// larger clients dump (only window flags do). Returns 0 on success, -1 on
+// malformed/truncated input.
+int hyprctl_parse_workspaces(const char* json, WorkspaceSnapshot* snap) {
+    memset(snap, 0, sizeof(*snap));
+
+    const char* p = json_skip_ws(json);
+    if (*p != '[') return -1;
+    p = json_skip_ws(p + 1);
+
+    while (*p == '{') {
+        int ws_id = 0;
+        int windows = 0;
+        int has_fullscreen = 0;
+        char name[64] = "";
+        char monitor[64] = "";
+
+        p = json_skip_ws(p + 1);
+        while (*p == '"') {
+            const char* key = p + 1;
+            p = json_skip_string(p);
+            if (!p) return -1;
+            size_t key_len = (size_t)(p - key - 1);
+
+            p = json_skip_ws(p);
+            if (*p != ':') return -1;
+            p = json_skip_ws(p + 1);
+
+            if (json_key_is(key, key_len, "id")) {
+                ws_id = atoi(p);
+            } else if (json_key_is(key, key_len, "windows")) {
+                windows = atoi(p);
+            } else if (json_key_is(key, key_len, "hasfullscreen")) {
+                has_fullscreen = (*p == 't');
+            } else if (json_key_is(key, key_len, "name")) {
+                json_copy_string(p, name, sizeof(name));
+            } else if (json_key_is(key, key_len, "monitor")) {
+                json_copy_string(p, monitor, sizeof(monitor));
+            }
+
+            p = json_skip_value(p);
+            if (!p) return -1;
+            p = json_skip_ws(p);
+            if (*p == ',') p = json_skip_ws(p + 1);
+        }
+        if (*p != '}') return -1;
+        p = json_skip_ws(p + 1);
+        if (*p == ',') p = json_skip_ws(p + 1);
+
+        if (ws_id >= 1 && ws_id <= MAX_WORKSPACES) {
+            // Regular workspace
+            snap->workspace_windows[ws_id - 1] = windows;
+            memcpy(snap->workspace_monitor[ws_id - 1], monitor, sizeof(monitor));
+            snap->has_fullscreen[ws_id - 1] = (unsigned char)has_fullscreen;
+            // Renamed: events and clients name it, so the model can't count it
+            if (name[0] != '\0' && ws_key_from_name(name, strlen(name)) != ws_id) {
+                snap->untracked[ws_id - 1] = 1;
+            }
+        } else if (strncmp(name, "special:", 8) == 0) {
+            // Special workspace special:N belongs to workspace N
+            int special_id = atoi(name + 8);
+            if (special_id >= 1 && special_id <= MAX_WORKSPACES) {
+                snap->special_windows[special_id - 1] = windows;
+            }
+        }
+    }
+
+    return *p == ']' ? 0 : -1;
+}
+
+// One client of a `hyprctl clients -j` reply
+typedef void (*ClientFunc)(void* ctx, uint64_t address, WorkspaceKey workspace,
+                           const char* app, unsigned flags, const char* title);
+
+// Walk a clients reply: only each client's address, class, title, workspace
+// name and fullscreen / floating state are used. Returns 0 on success, -1 on
+// malformed/truncated input (after visiting the clients before the damage).
+static int parse_clients(const char* json, ClientFunc visit, void* ctx) {
+    const char* p = json_skip_ws(json);
+    if (*p != '[') return -1;
+    p = json_skip_ws(p + 1);
+
+    while (*p == '{') {
+        uint64_t address = 0;
+        char workspace[64] = "";
+        char app[APP_CLASS_NAME_MAX] = "";
+        char title[WINDOW_TITLE_MAX] = "";
+        unsigned flags = 0;
+
+        p = json_skip_ws(p + 1);
+        while (*p == '"') {
+            const char* key = p + 1;
+            p = json_skip_string(p);
+            if (!p) return -1;
+            size_t key_len = (size_t)(p - key - 1);
+
+            p = json_skip_ws(p);
+            if (*p != ':') return -1;
+            p = json_skip_ws(p + 1);
+
+            if (json_key_is(key, key_len, "address") && *p == '"') {
+                address = strtoull(p + 1, NULL, 16);
+            } else if (json_key_is(key, key_len, "class") && *p == '"') {
+                json_copy_string(p, app, sizeof(app));
+            } else if (json_key_is(key, key_len, "title") && *p == '"') {
+                json_copy_text(p, title, sizeof(title));
+            } else if (json_key_is(key, key_len, "floating")) {
+                if (*p == 't') flags |= WINDOW_FLOATING;
+            } else if (json_key_is(key, key_len, "fullscreen")) {
+                // A mode number (0 = none) on current Hyprland, a bool on older
+                if (*p == 't' || (*p >= '1' && *p <= '9')) flags |= WINDOW_FULLSCREEN;
+            } else if (json_key_is(key, key_len, "workspace") && *p == '{') {
+                // "workspace": {"id": 3, "name": "3"}
+                const char* w = json_skip_ws(p + 1);
+                while (*w == '"') {
+                    const char* wkey = w + 1;
+                    w = json_skip_string(w);
+                    if (!w) return -1;
+                    size_t wkey_len = (size_t)(w - wkey - 1);
+                    w = json_skip_ws(w);
+                    if (*w != ':') return -1;
+                    w = json_skip_ws(w + 1);
+                    if (json_key_is(wkey, wkey_len, "name")) {
+                        json_copy_string(w, workspace, sizeof(workspace));
+                    }
+                    w = json_skip_value(w);
+                    if (!w) return -1;
+                    w = json_skip_ws(w);
+                    if (*w == ',') w = json_skip_ws(w + 1);
+                }
+            }
+
+            p = json_skip_value(p);
+            if (!p) return -1;
+            p = json_skip_ws(p);
+            if (*p == ',') p = json_skip_ws(p + 1);
+        }
+        if (*p != '}') return -1;
+        p = json_skip_ws(p + 1);
+        if (*p == ',') p = json_skip_ws(p + 1);
+
+        visit(ctx, address, ws_key_from_name(workspace, strlen(workspace)), app, flags, title);
+    }
+
+    return *p == ']' ? 0 : -1;
+}
+
+static void add_client(void* ctx, uint64_t address, WorkspaceKey workspace, const char* app,
+                       unsigned flags, const char* title) {
+    ws_state_add_window(ctx, address, workspace, app_class_intern(app, strlen(app)), flags, title);
+}
+
+int hyprctl_parse_clients(const char* json, WorkspaceState* st) {
+    ws_state_clear_windows(st);
+    return parse_clients(json, add_client, st);
+}
+
+typedef struct {
+    WorkspaceState* st;
+    unsigned mask;
+    int changed;
+} ClientFlagsCtx;
+
+static void apply_client_flags(void* ctx, uint64_t address, WorkspaceKey workspace,
+                               const char* app, unsigned flags, const char* title) {
+    (void)workspace;
+    (void)app;
+    (void)title;
+    ClientFlagsCtx* c = ctx;
+    if (ws_state_set_window_flags(c->st, address, flags, c->mask)) c->changed = 1;
+}
+
+int hyprctl_parse_client_flags(const char* json, WorkspaceState* st, unsigned mask, int* changed) {
+    ClientFlagsCtx ctx = { st, mask, 0 };
+    int ret = parse_clients(json, apply_client_flags, &ctx);
+    *changed = ctx.changed;
+    return ret;
+}
+
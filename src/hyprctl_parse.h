@@ -0,0 +1,22 @@
+/**
+ * Parsers for hyprctl JSON replies.
+ *
+ * Both take a NUL-terminated reply and return 0 on success or -1 on
+ * malformed/truncated input.
+ */
+
+#pragma once
+
+#include "workspace_state.h"
+
+// `hyprctl workspaces -j`: window counts and monitor of every workspace
+int hyprctl_parse_workspaces(const char* json, WorkspaceSnapshot* snap);
+
+// `hyprctl clients -j`: (re)seeds the window table of st. On failure the
+// table may be partially filled; callers clear it.
+int hyprctl_parse_clients(const char* json, WorkspaceState* st);
+
+// `hyprctl clients -j`: only the mask bits (WINDOW_FULLSCREEN /
+// WINDOW_FLOATING) of windows already in the table of st, for reconciling
+// window flags. *changed is set if any window's flags changed.
+int hyprctl_parse_client_flags(const char* json, WorkspaceState* st, unsigned mask, int* changed);
@@ -0,0 +1,649 @@
+/**
+ * Hyprland IPC client - see ipc_client.h
+ */
+
+#include "ipc_client.h"
+#include "command.h"
+#include "event_scan.h"
+#include "hyprctl_parse.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// Reconnect backoff while Hyprland's socket is unavailable
+#define RECONNECT_BACKOFF_MIN_MS 250
+#define RECONNECT_BACKOFF_MAX_MS 8000
+
+// Event lines scanned per event_scan_lines() call in the reader
+#define SCAN_SPANS 64
+
+// How often the reader retries parked events while the socket is quiet
+#define PARKED_RETRY_MS 10
+
+// Scratch space for one hyprctl reply and everything parsed from it. Only
+// touched pages become resident; replies that don't fit fail to parse.
+#define QUERY_ARENA_CAPACITY (1024 * 1024)
+
+// IPC thread stacks: nothing large lives on either since query buffers moved
+// into the arena (glibc's default is 8 MB of address space per thread)
+#define READER_STACK_SIZE (64 * 1024)
+#define WORKER_STACK_SIZE (256 * 1024)
+
+// Counters are only ever summed, so relaxed ordering is enough
+#define STAT_ADD(counter, n) atomic_fetch_add_explicit(&(counter), (n), memory_order_relaxed)
+#define STAT_GET(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+
+static void refresh_workspaces(IpcClient* client);
+static void refresh_windows(IpcClient* client);
+
+// Parse workspace state from hyprctl using jq
+static void fetch_initial_state(IpcClient* client) {
+    char cmd[256];
+
+    // Focused monitor - new workspaces are created there
+    popen_string("hyprctl monitors -j | jq -r '.[] | select(.focused == true) | .name' 2>/dev/null",
+                 client->state.focused_monitor, sizeof(client->state.focused_monitor));
+
+    // Get THIS monitor's active workspace and focus state
+    if (client->state.monitor_name[0] != '\0') {
+        snprintf(cmd, sizeof(cmd),
+                 "hyprctl monitors -j | jq -r '.[] | select(.name == \"%s\") | .activeWorkspace.id' 2>/dev/null",
+                 client->state.monitor_name);
+        client->state.this_monitor_workspace = popen_int(cmd);
+        client->state.user_focused_here = (strcmp(client->state.focused_monitor, client->state.monitor_name) == 0);
+    } else {
+        // Fallback if monitor not yet detected
+        client->state.this_monitor_workspace = popen_int("hyprctl activeworkspace -j | jq -r '.id' 2>/dev/null");
+        client->state.user_focused_here = 1;
+    }
+
+    // Window counts and monitor assignments, all from one workspaces reply
+    refresh_workspaces(client);
+
+    // Address table so window events update counts without further queries
+    refresh_windows(client);
+}
+
+// Refresh window counts and workspace-to-monitor mapping with a single hyprctl call
+static void refresh_workspaces(IpcClient* client) {
+    Arena* arena = &client->query_arena;
+    arena_reset(arena);
+
+    const char* reply = read_command_output(arena, "hyprctl workspaces -j 2>/dev/null");
+    if (!reply) return;
+
+    // Parse into a snapshot first so a bad reply never leaves half-reset state
+    WorkspaceSnapshot* snap = arena_alloc(arena, sizeof(*snap));
+    if (!snap || hyprctl_parse_workspaces(reply, snap) < 0) {
+        fprintf(stderr, "workspace_buttons: Failed to parse hyprctl workspaces reply\n");
+        return;
+    }
+    ws_state_apply_snapshot(&client->state, snap);
+}
+
+// Reseed the window table. Runs only on (re)sync; a failed or truncated reply
+// leaves the table empty, and window events then fall back to refresh_workspaces.
+static void refresh_windows(IpcClient* client) {
+    arena_reset(&client->query_arena);
+
+    const char* reply = read_command_output(&client->query_arena, "hyprctl clients -j 2>/dev/null");
+    pthread_mutex_lock(&client->windows_lock);
+    if (!reply || hyprctl_parse_clients(reply, &client->state) < 0) {
+        ws_state_clear_windows(&client->state);
+    }
+    pthread_mutex_unlock(&client->windows_lock);
+}
+
+// Take window flags from a clients reply: windows that open fullscreen or
+// floating announce it with no event. That is not drift, just state events
+// don't carry, so the table is updated in place. Floating is only followed
+// with has-floating. Returns non-zero if any flag changed.
+static int reconcile_window_flags(IpcClient* client, unsigned mask) {
+    arena_reset(&client->query_arena);
+    const char* reply = read_command_output(&client->query_arena, "hyprctl clients -j 2>/dev/null");
+    if (!reply) return 0;
+
+    int changed = 0;
+    pthread_mutex_lock(&client->windows_lock);
+    hyprctl_parse_client_flags(reply, &client->state, mask, &changed);
+    pthread_mutex_unlock(&client->windows_lock);
+    return changed;
+}
+
+// Compare the event-driven model against compositor truth: counts and monitors
+// from the workspaces reply, then window flags from a clients reply - skipped
+// without has-floating unless the workspaces reply disagrees about fullscreen.
+// Returns non-zero if the render may have changed (drift was found and a full
+// refresh was done, or window flags were updated).
+static int reconcile_state(IpcClient* client) {
+    Arena* arena = &client->query_arena;
+    arena_reset(arena);
+
+    STAT_ADD(client->stats.reconciles, 1);
+    const char* reply = read_command_output(arena, "hyprctl workspaces -j 2>/dev/null");
+    WorkspaceSnapshot* truth = arena_alloc(arena, sizeof(*truth));
+    WorkspaceSnapshot* model = arena_alloc(arena, sizeof(*model));
+    if (!reply || !truth || !model || hyprctl_parse_workspaces(reply, truth) < 0) {
+        return 0;
+    }
+
+    ws_state_snapshot(&client->state, model);
+    ws_snapshot_merge_untracked(truth, model);
+    if (ws_snapshot_hash(truth) == ws_snapshot_hash(model)) {
+        unsigned mask = client->view.has_floating ? WINDOW_FULLSCREEN | WINDOW_FLOATING : 0;
+        for (int i = 0; i < MAX_WORKSPACES && !mask; i++) {
+            if (!truth->untracked[i] && truth->has_fullscreen[i] != model->has_fullscreen[i]) {
+                mask = WINDOW_FULLSCREEN;
+            }
+        }
+        return mask ? reconcile_window_flags(client, mask) : 0;
+    }
+
+    // Missed events or an event-handling bug - rebuild everything
+    unsigned long corrections = STAT_ADD(client->stats.drift_corrections, 1) + 1;
+    fprintf(stderr, "workspace_buttons: Reconcile found drift, refreshing (%lu corrections so far)\n",
+            corrections);
+    fetch_initial_state(client);
+    return 1;
+}
+
+// Compute the render state and hand it to the UI
+static void publish_render(IpcClient* client, int notify) {
+    WorkspaceRender render;
+    ws_state_render(&client->state, &client->view, &render);
+
+    pthread_mutex_lock(&client->render_lock);
+    client->render = render;
+    pthread_mutex_unlock(&client->render_lock);
+
+    STAT_ADD(client->stats.commits, 1);
+    atomic_store_explicit(&client->stats.query_arena_high_water, client->query_arena.high_water,
+                          memory_order_relaxed);
+    if (notify && client->on_commit) {
+        client->on_commit(client->user_data);
+    }
+}
+
+// Connect to Hyprland's event socket
+// Errors are only logged when log_errors is set, so retries don't flood the log
+static int connect_hyprland_socket(int log_errors) {
+    const char* xdg_runtime = getenv("XDG_RUNTIME_DIR");
+    const char* hypr_sig = getenv("HYPRLAND_INSTANCE_SIGNATURE");
+
+    if (!xdg_runtime || !hypr_sig) {
+        if (log_errors) {
+            fprintf(stderr, "workspace_buttons: Missing Hyprland environment variables\n");
+        }
+        return -1;
+    }
+
+    char socket_path[256];
+    snprintf(socket_path, sizeof(socket_path), "%s/hypr/%s/.socket2.sock", xdg_runtime, hypr_sig);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        if (log_errors) perror("workspace_buttons: socket");
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        if (log_errors) perror("workspace_buttons: connect");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void batch_histogram_add(BatchHistogram* hist, size_t batch_size) {
+    int bucket = 0;
+    while (batch_size > 1 && bucket < BATCH_HISTOGRAM_BUCKETS - 1) {
+        batch_size >>= 1;
+        bucket++;
+    }
+    STAT_ADD(hist->buckets[bucket], 1);
+}
+
+// Format as "1:N 2:N 4:N ... 64+:N"
+static void batch_histogram_format(BatchHistogram* hist, char* out, size_t out_size) {
+    size_t len = 0;
+    out[0] = '\0';
+    for (int i = 0; i < BATCH_HISTOGRAM_BUCKETS && len < out_size; i++) {
+        len += snprintf(out + len, out_size - len, "%s%d%s:%lu", i ? " " : "", 1 << i,
+                        i == BATCH_HISTOGRAM_BUCKETS - 1 ? "+" : "", STAT_GET(hist->buckets[i]));
+    }
+}
+
+// Drain an eventfd counter
+static void drain_eventfd(int fd) {
+    uint64_t count;
+    if (read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        perror("workspace_buttons: eventfd read");
+    }
+}
+
+static void signal_eventfd(int fd) {
+    uint64_t one = 1;
+    if (write(fd, &one, sizeof(one)) < 0) {
+        perror("workspace_buttons: eventfd write");
+    }
+}
+
+// Sleep up to timeout_ms (-1 = forever), returning non-zero early if woken via fd
+static int wait_for_wake(IpcClient* client, int fd, int timeout_ms) {
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    int ret;
+    do {
+        ret = poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR && atomic_load(&client->running));
+
+    if (ret > 0) {
+        drain_eventfd(fd);
+    }
+    return ret > 0 || !atomic_load(&client->running);
+}
+
+// Ask the state worker for a full refetch (events were missed)
+static void request_resync(IpcClient* client) {
+    atomic_store(&client->resync_requested, 1);
+    signal_eventfd(client->worker_fd);
+}
+
+// Classify one scanned event line and push it to the queue. Returns 1 if queued, else 0.
+// Events that don't fit are parked (and coalesced where a newer one supersedes them).
+static int queue_event_line(IpcClient* client, const char* line, const EventSpan* span) {
+    // A resync is pending: the worker discards the queue when it starts, and
+    // its queries cover this event
+    if (atomic_load_explicit(&client->resync_requested, memory_order_relaxed)) {
+        STAT_ADD(client->stats.superseded, 1);
+        return 0;
+    }
+    int ret = event_queue_push_line(&client->queue, line, span);
+    if (ret < 0) {
+        // Worker is behind on more than titles - it will rebuild state from scratch instead
+        atomic_store(&client->resync_requested, 1);
+        return 0;
+    }
+    return ret;
+}
+
+// Socket reader thread: drains socket2 into the event queue and never blocks
+// on anything but the socket, so Hyprland always sees us keep up
+static void* ipc_reader_thread(void* arg) {
+    IpcClient* client = arg;
+    char buffer[4096];
+    EventSpan spans[SCAN_SPANS];
+    size_t pending = 0;       // Bytes of an incomplete line kept at buffer start
+    int discarding = 0;       // Skipping the rest of an overlong line
+    int backoff_ms = RECONNECT_BACKOFF_MIN_MS;
+    int missed_events = 0;    // Set once events may have been missed
+    int socket_fd = -1;       // Owned by this thread alone
+
+    while (atomic_load(&client->running)) {
+        // Bar hidden: drop the connection so Hyprland events cost no wakeups at all,
+        // and take a single resync snapshot once the bar is shown again
+        if (atomic_load(&client->suspended)) {
+            if (socket_fd >= 0) {
+                close(socket_fd);
+                socket_fd = -1;
+            }
+            missed_events = 1;
+            backoff_ms = RECONNECT_BACKOFF_MIN_MS;
+            wait_for_wake(client, client->wake_fd, -1);
+            continue;
+        }
+
+        // (Re)connect, backing off exponentially while Hyprland is unavailable
+        if (socket_fd < 0) {
+            socket_fd = connect_hyprland_socket(backoff_ms == RECONNECT_BACKOFF_MIN_MS);
+            if (socket_fd < 0) {
+                if (backoff_ms == RECONNECT_BACKOFF_MIN_MS) {
+                    fprintf(stderr, "workspace_buttons: Failed to connect to Hyprland socket, retrying\n");
+                }
+                missed_events = 1;
+                if (wait_for_wake(client, client->wake_fd, backoff_ms)) continue;
+                backoff_ms *= 2;
+                if (backoff_ms > RECONNECT_BACKOFF_MAX_MS) backoff_ms = RECONNECT_BACKOFF_MAX_MS;
+                continue;
+            }
+            backoff_ms = RECONNECT_BACKOFF_MIN_MS;
+            pending = 0;
+            discarding = 0;
+
+            // Non-blocking from here on, so each wakeup can drain until EAGAIN
+            fcntl(socket_fd, F_SETFL, fcntl(socket_fd, F_GETFL) | O_NONBLOCK);
+
+            // Events were lost while disconnected or suspended - rebuild full state
+            // (which also supersedes any events still parked)
+            if (missed_events) {
+                client->queue.parked_count = 0;
+                request_resync(client);
+                missed_events = 0;
+            }
+        }
+
+        struct pollfd fds[2] = {
+            { .fd = socket_fd, .events = POLLIN },
+            { .fd = client->wake_fd, .events = POLLIN },
+        };
+        // Parked events are retried on a short timer, so a quiet socket can't strand them
+        int ready = poll(fds, 2, client->queue.parked_count ? PARKED_RETRY_MS : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("workspace_buttons: poll");
+            break;
+        }
+        if (ready == 0) {
+            size_t parked = client->queue.parked_count;
+            if (event_queue_flush_parked(&client->queue) < parked) {
+                signal_eventfd(client->worker_fd);
+            }
+            continue;
+        }
+
+        // Shutdown, suspend or resume requested - re-check state at the top of the loop
+        if (fds[1].revents) {
+            drain_eventfd(client->wake_fd);
+            continue;
+        }
+
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+        // Drain everything Hyprland has buffered so a burst becomes one batch,
+        // one state commit and at most one UI pass
+        size_t queued = 0;
+        int disconnected = 0;
+        for (;;) {
+            ssize_t bytes = read(socket_fd, buffer + pending, sizeof(buffer) - pending);
+            if (bytes < 0 && errno == EINTR) continue;
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (bytes <= 0) {
+                disconnected = 1;
+                break;
+            }
+
+            // Split complete lines into events; an incomplete tail waits for the next read
+            size_t total = pending + (size_t)bytes;
+            size_t start = 0;
+            size_t count;
+
+            do {
+                size_t consumed;
+                count = event_scan_lines(buffer + start, total - start, spans, SCAN_SPANS, &consumed);
+                for (size_t i = 0; i < count; i++) {
+                    if (discarding) {
+                        discarding = 0;
+                    } else if (spans[i].len > 0) {
+                        queued += queue_event_line(client, buffer + start + spans[i].start, &spans[i]);
+                    }
+                }
+                start += consumed;
+            } while (count == SCAN_SPANS);
+
+            pending = total - start;
+            if (pending == sizeof(buffer)) {
+                // A single line filled the whole buffer - drop it up to its newline
+                pending = 0;
+                discarding = 1;
+            } else if (pending > 0) {
+                memmove(buffer, buffer + start, pending);
+            }
+
+            // Very long bursts: let the worker start before the queue overflows
+            if (event_queue_depth(&client->queue) > EVENT_QUEUE_CAPACITY / 2) {
+                signal_eventfd(client->worker_fd);
+            }
+        }
+
+        if (queued > 0) {
+            batch_histogram_add(&client->stats.read_batches, queued);
+        }
+        if (queued > 0 || atomic_load(&client->resync_requested)) {
+            signal_eventfd(client->worker_fd);
+        }
+
+        if (disconnected) {
+            fprintf(stderr, "workspace_buttons: Lost connection to Hyprland socket\n");
+            close(socket_fd);
+            socket_fd = -1;
+            missed_events = 1;
+        }
+    }
+
+    if (socket_fd >= 0) {
+        close(socket_fd);
+        socket_fd = -1;
+    }
+    return NULL;
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// State worker thread: applies queued events to the model and runs follow-up
+// hyprctl queries (refreshes, resyncs, reconciles) without stalling the reader
+static void* state_worker_thread(void* arg) {
+    IpcClient* client = arg;
+    int64_t reconcile_interval_ms = (int64_t)client->reconcile_interval * 1000;
+    int64_t next_reconcile = monotonic_ms() + reconcile_interval_ms;
+
+    while (atomic_load(&client->running)) {
+        int needs_update = 0;
+        int watched = atomic_load_explicit(&client->tooltip_workspace, memory_order_relaxed);
+        unsigned watched_serial = watched ? client->state.window_serial[watched - 1] : 0;
+
+        // Full refetch after a reconnect, resume or queue overflow
+        if (atomic_exchange(&client->resync_requested, 0)) {
+            STAT_ADD(client->stats.resyncs, 1);
+            // Everything queued so far predates the refetch, which covers it;
+            // dropping it now gives the reader room while the queries run
+            event_queue_discard(&client->queue);
+            fetch_initial_state(client);
+            needs_update = 1;
+            next_reconcile = monotonic_ms() + reconcile_interval_ms;
+        }
+
+        // Apply everything queued as one state commit. Batches of title
+        // changes alone leave the render as it is and publish nothing.
+        const HyprEvent* event;
+        size_t batch = 0;
+        pthread_mutex_lock(&client->windows_lock);
+        while ((event = event_queue_peek(&client->queue)) != NULL) {
+            if (ws_state_apply_event(&client->state, event)) needs_update = 1;
+            event_queue_pop(&client->queue);
+            batch++;
+        }
+        pthread_mutex_unlock(&client->windows_lock);
+        if (batch > 0) {
+            STAT_ADD(client->stats.events, batch);
+            batch_histogram_add(&client->stats.commit_batches, batch);
+        }
+
+        if (client->state.refresh_pending) {
+            client->state.refresh_pending = 0;
+            refresh_workspaces(client);
+        }
+
+        // Windows that open floating say so in no event: with has-floating,
+        // one clients query per batch of new windows picks it up
+        if (client->state.flags_pending) {
+            client->state.flags_pending = 0;
+            if (client->view.has_floating) {
+                if (reconcile_window_flags(client, WINDOW_FULLSCREEN | WINDOW_FLOATING)) {
+                    needs_update = 1;
+                }
+            }
+        }
+
+        // Low-frequency reconcile, skipped while the bar is hidden
+        int timeout_ms = -1;
+        if (reconcile_interval_ms > 0) {
+            int64_t now = monotonic_ms();
+            if (now >= next_reconcile) {
+                if (!atomic_load(&client->suspended) && reconcile_state(client)) {
+                    needs_update = 1;
+                }
+                now = monotonic_ms();
+                next_reconcile = now + reconcile_interval_ms;
+            }
+            timeout_ms = (int)(next_reconcile - now);
+        }
+
+        // Publish a single render state for all events in this batch; an open
+        // tooltip whose windows changed only needs the UI to ask again
+        if (needs_update) {
+            publish_render(client, 1);
+        } else if (watched && client->state.window_serial[watched - 1] != watched_serial &&
+                   client->on_commit) {
+            client->on_commit(client->user_data);
+        }
+
+        wait_for_wake(client, client->worker_fd, timeout_ms);
+    }
+
+    return NULL;
+}
+
+int ipc_client_init(IpcClient* client, const ModuleConfig* config,
+                    IpcCommitFunc on_commit, void* user_data) {
+    memset(client, 0, sizeof(*client));
+    ws_state_init(&client->state);
+    client->view = config->view;
+    client->reconcile_interval = config->reconcile_interval;
+    client->on_commit = on_commit;
+    client->user_data = user_data;
+    atomic_init(&client->running, 1);
+    atomic_init(&client->suspended, 0);
+    atomic_init(&client->resync_requested, 0);
+    atomic_init(&client->tooltip_workspace, 0);
+    ws_state_render(&client->state, &client->view, &client->render);
+
+    client->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    client->worker_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (client->wake_fd < 0 || client->worker_fd < 0) {
+        perror("workspace_buttons: eventfd");
+        if (client->wake_fd >= 0) close(client->wake_fd);
+        if (client->worker_fd >= 0) close(client->worker_fd);
+        return -1;
+    }
+    if (arena_init(&client->query_arena, QUERY_ARENA_CAPACITY) < 0) {
+        perror("workspace_buttons: mmap");
+        close(client->wake_fd);
+        close(client->worker_fd);
+        return -1;
+    }
+    pthread_mutex_init(&client->render_lock, NULL);
+    pthread_mutex_init(&client->windows_lock, NULL);
+    return 0;
+}
+
+void ipc_client_destroy(IpcClient* client) {
+    atomic_store(&client->running, 0);
+    if (client->started) {
+        // Wake both threads out of poll() so the join never waits on Hyprland
+        signal_eventfd(client->wake_fd);
+        signal_eventfd(client->worker_fd);
+        pthread_join(client->reader_thread, NULL);
+        pthread_join(client->worker_thread, NULL);
+        client->started = 0;
+    }
+    close(client->wake_fd);
+    close(client->worker_fd);
+    arena_destroy(&client->query_arena);
+    pthread_mutex_destroy(&client->render_lock);
+    pthread_mutex_destroy(&client->windows_lock);
+}
+
+void ipc_client_fetch(IpcClient* client) {
+    // Refetch on the state worker so the queries never race event handling
+    if (client->started) {
+        request_resync(client);
+        return;
+    }
+    fetch_initial_state(client);
+    publish_render(client, 0);
+}
+
+int ipc_client_start(IpcClient* client) {
+    if (client->started) return 0;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    pthread_attr_setstacksize(&attr, WORKER_STACK_SIZE);
+    if (pthread_create(&client->worker_thread, &attr, state_worker_thread, client) != 0) {
+        fprintf(stderr, "workspace_buttons: Failed to start state worker thread\n");
+        pthread_attr_destroy(&attr);
+        return -1;
+    }
+    pthread_attr_setstacksize(&attr, READER_STACK_SIZE);
+    int reader_failed = pthread_create(&client->reader_thread, &attr, ipc_reader_thread, client) != 0;
+    pthread_attr_destroy(&attr);
+    if (reader_failed) {
+        fprintf(stderr, "workspace_buttons: Failed to start IPC reader thread\n");
+        atomic_store(&client->running, 0);
+        signal_eventfd(client->worker_fd);
+        pthread_join(client->worker_thread, NULL);
+        return -1;
+    }
+    client->started = 1;
+    return 0;
+}
+
+void ipc_client_set_suspended(IpcClient* client, int suspended) {
+    if (atomic_exchange(&client->suspended, suspended) == suspended) return;
+    if (client->started) {
+        signal_eventfd(client->wake_fd);
+    }
+}
+
+void ipc_client_render(IpcClient* client, WorkspaceRender* render) {
+    pthread_mutex_lock(&client->render_lock);
+    *render = client->render;
+    pthread_mutex_unlock(&client->render_lock);
+}
+
+int ipc_client_window_list(IpcClient* client, int ws, WindowListCache* cache) {
+    pthread_mutex_lock(&client->windows_lock);
+    int rebuilt = ws_state_window_list(&client->state, ws, cache);
+    pthread_mutex_unlock(&client->windows_lock);
+    return rebuilt;
+}
+
+void ipc_client_watch_tooltip(IpcClient* client, int ws) {
+    atomic_store_explicit(&client->tooltip_workspace, ws, memory_order_relaxed);
+}
+
+void ipc_client_print_stats(IpcClient* client, FILE* out, const char* prefix) {
+    char read_batches[128];
+    char commit_batches[128];
+    batch_histogram_format(&client->stats.read_batches, read_batches, sizeof(read_batches));
+    batch_histogram_format(&client->stats.commit_batches, commit_batches, sizeof(commit_batches));
+
+    fprintf(out, "%s events=%lu commits=%lu resyncs=%lu superseded=%lu reconciles=%lu "
+            "drift_corrections=%lu queue_depth=%zu queue_high_water=%zu queue_dropped=%lu "
+            "queue_coalesced=%lu\n",
+            prefix, STAT_GET(client->stats.events), STAT_GET(client->stats.commits),
+            STAT_GET(client->stats.resyncs), STAT_GET(client->stats.superseded),
+            STAT_GET(client->stats.reconciles),
+            STAT_GET(client->stats.drift_corrections), event_queue_depth(&client->queue),
+            STAT_GET(client->queue.high_water), STAT_GET(client->queue.dropped),
+            STAT_GET(client->queue.coalesced));
+    fprintf(out, "%s read_batches={%s} commit_batches={%s} query_arena_high_water=%zu\n",
+            prefix, read_batches, commit_batches, STAT_GET(client->stats.query_arena_high_water));
+}
@@ -0,0 +1,118 @@
+/**
+ * Hyprland IPC client: socket reader and state worker threads around a
+ * WorkspaceState, independent of GTK.
+ *
+ * The reader drains socket2 into the event queue; the worker applies events,
+ * runs follow-up hyprctl queries and, after every commit, publishes a
+ * WorkspaceRender under render_lock and calls on_commit. The UI never reads
+ * the state itself, only the published render - except for tooltip window
+ * lists, which it builds on demand from the window table under windows_lock.
+ * Title changes don't publish anything; they only notify while the UI
+ * watches that workspace's tooltip.
+ *
+ * Threading: ipc_client_init/fetch/start/destroy, set_suspended and
+ * request_resync are called from one (UI) thread; ipc_client_render and
+ * ipc_client_window_list from any.
+ * Before ipc_client_start() the UI thread may also set up `state` directly
+ * (e.g. the monitor name); afterwards it belongs to the worker.
+ */
+
+#pragma once
+
+#include "arena.h"
+#include "event_queue.h"
+#include "module_config.h"
+#include "workspace_state.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+// Power-of-two batch size buckets: 1, 2-3, 4-7, ..., 64+
+#define BATCH_HISTOGRAM_BUCKETS 7
+
+typedef struct {
+    _Atomic unsigned long buckets[BATCH_HISTOGRAM_BUCKETS];
+} BatchHistogram;
+
+// Runtime counters, written by the IPC threads and read from any thread
+typedef struct {
+    _Atomic unsigned long events;             // Events applied by the state worker
+    _Atomic unsigned long commits;            // Render states published
+    _Atomic unsigned long resyncs;            // Full resyncs after reconnect/resume
+    _Atomic unsigned long superseded;         // Events not queued since a pending resync covers them
+    _Atomic unsigned long reconciles;         // Background reconcile checks
+    _Atomic unsigned long drift_corrections;  // Reconciles that found the model out of sync
+    BatchHistogram read_batches;              // Events queued per reader wakeup (reader thread)
+    BatchHistogram commit_batches;            // Events applied per state commit (state worker)
+    _Atomic size_t query_arena_high_water;    // Largest hyprctl query footprint
+} IpcStats;
+
+// Called on the worker thread after each published commit. Must be cheap,
+// thread-safe and must not call back into the client.
+typedef void (*IpcCommitFunc)(void* user_data);
+
+typedef struct {
+    // Workspace model (monitor name, focus, window counts and table)
+    WorkspaceState state;
+    WorkspaceViewConfig view;
+    int reconcile_interval;      // Seconds between background reconciles, 0 = off
+
+    IpcStats stats;
+
+    // Last published render state
+    pthread_mutex_t render_lock;
+    WorkspaceRender render;
+
+    // Held by the worker while it changes the window table, and by readers of
+    // window lists
+    pthread_mutex_t windows_lock;
+    atomic_int tooltip_workspace;   // Workspace whose tooltip is open, 0 if none
+
+    IpcCommitFunc on_commit;
+    void* user_data;
+
+    pthread_t reader_thread;
+    pthread_t worker_thread;
+    int started;
+    atomic_int running;
+    atomic_int suspended;        // Bar hidden: reader drops its connection
+    atomic_int resync_requested; // Events were missed, worker refetches everything
+    int wake_fd;                 // eventfd, wakes the reader on shutdown/suspend/resume
+    int worker_fd;               // eventfd, wakes the worker on new events/shutdown
+    EventQueue queue;
+
+    // Per-query scratch memory, reset at the start of every query. Queries run
+    // on the UI thread until the worker starts and on the worker after.
+    Arena query_arena;
+} IpcClient;
+
+// Returns -1 (with errno-style logging) if eventfds or the arena can't be set up
+int ipc_client_init(IpcClient* client, const ModuleConfig* config,
+                    IpcCommitFunc on_commit, void* user_data);
+
+// Stop and join the threads (if started) and release everything
+void ipc_client_destroy(IpcClient* client);
+
+// Fetch full state from hyprctl and publish it. Before ipc_client_start()
+// this runs on the calling thread; afterwards it asks the worker to resync.
+void ipc_client_fetch(IpcClient* client);
+
+// Start the reader and worker threads (once). Returns -1 on failure.
+int ipc_client_start(IpcClient* client);
+
+// Suspend or resume IPC processing; resuming resyncs once
+void ipc_client_set_suspended(IpcClient* client, int suspended);
+
+// Copy out the last published render state
+void ipc_client_render(IpcClient* client, WorkspaceRender* render);
+
+// Bring cache up to date with the windows on workspace ws (see
+// ws_state_window_list). Returns 1 if the text was rebuilt.
+int ipc_client_window_list(IpcClient* client, int ws, WindowListCache* cache);
+
+// Workspace whose tooltip the UI shows (0: none). While set, title changes
+// there call on_commit even though the render stays the same.
+void ipc_client_watch_tooltip(IpcClient* client, int ws);
+
+// Print runtime counters, one line per group, each prefixed with prefix
+void ipc_client_print_stats(IpcClient* client, FILE* out, const char* prefix);
@@ -0,0 +1,181 @@
+/**
+ * Workspace label templates - see label_format.h
+ */
+
+#include "label_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const icon_state_keys[LABEL_ICON_STATE_COUNT] = {
+    "active", "visible", "empty", "default",
+};
+
+// Copy s into the pool, returning its offset or -1 if it doesn't fit
+static int pool_add(LabelFormat* fmt, const char* s, size_t len) {
+    if (fmt->pool_used + len + 1 > sizeof(fmt->pool)) return -1;
+    int offset = fmt->pool_used;
+    memcpy(fmt->pool + offset, s, len);
+    fmt->pool[offset + len] = '\0';
+    fmt->pool_used += (int)len + 1;
+    return offset;
+}
+
+void label_format_init(LabelFormat* fmt) {
+    memset(fmt, 0, sizeof(*fmt));
+    label_format_compile(fmt, "{id}");
+}
+
+// End a literal run: store it as a text token
+static int flush_literal(LabelFormat* fmt, LabelToken* tokens, int* count,
+                         const char* literal, size_t* literal_len) {
+    if (*literal_len == 0) return 0;
+    int offset = pool_add(fmt, literal, *literal_len);
+    if (offset < 0 || *count == LABEL_FORMAT_TOKENS_MAX) return -1;
+    tokens[(*count)++] = (LabelToken){ LABEL_TOKEN_TEXT, (unsigned short)offset };
+    *literal_len = 0;
+    return 0;
+}
+
+int label_format_compile(LabelFormat* fmt, const char* format) {
+    LabelToken tokens[LABEL_FORMAT_TOKENS_MAX];
+    int count = 0;
+    unsigned inputs = 0;
+    int pool_used = fmt->pool_used;
+    char literal[LABEL_FORMAT_POOL];
+    size_t literal_len = 0;
+    const char* p = format;
+
+    while (*p) {
+        // Literal text; "{{" and "}}" are braces
+        if (*p != '{' || p[1] == '{') {
+            if (*p == '}' && p[1] != '}') goto fail;
+            if (literal_len + 1 >= sizeof(literal)) goto fail;
+            literal[literal_len++] = *p;
+            p += (*p == '{' || *p == '}') ? 2 : 1;
+            continue;
+        }
+
+        if (flush_literal(fmt, tokens, &count, literal, &literal_len) < 0) goto fail;
+        const char* end = strchr(p, '}');
+        if (!end || count == LABEL_FORMAT_TOKENS_MAX) goto fail;
+        size_t len = (size_t)(end - p - 1);
+        LabelToken token = { LABEL_TOKEN_TEXT, 0 };
+        if ((len == 2 && strncmp(p + 1, "id", 2) == 0) ||
+            (len == 4 && strncmp(p + 1, "name", 4) == 0)) {
+            token.kind = LABEL_TOKEN_ID;
+            inputs |= LABEL_INPUT_ID;
+        } else if (len == 4 && strncmp(p + 1, "icon", 4) == 0) {
+            token.kind = LABEL_TOKEN_ICON;
+            inputs |= LABEL_INPUT_ID | LABEL_INPUT_CLASSES;
+        } else if (len == 7 && strncmp(p + 1, "windows", 7) == 0) {
+            token.kind = LABEL_TOKEN_WINDOWS;
+            inputs |= LABEL_INPUT_WINDOWS;
+        } else {
+            goto fail;
+        }
+        tokens[count++] = token;
+        p = end + 1;
+    }
+    if (flush_literal(fmt, tokens, &count, literal, &literal_len) < 0) goto fail;
+
+    memcpy(fmt->tokens, tokens, (size_t)count * sizeof(LabelToken));
+    fmt->token_count = count;
+    fmt->inputs = inputs;
+    return 0;
+
+fail:
+    fmt->pool_used = pool_used;
+    return -1;
+}
+
+int label_format_set_icon(LabelFormat* fmt, const char* key, const char* icon) {
+    unsigned short* slot = NULL;
+
+    for (int i = 0; i < LABEL_ICON_STATE_COUNT; i++) {
+        if (strcmp(key, icon_state_keys[i]) == 0) slot = &fmt->state_icon[i];
+    }
+    if (!slot) {
+        char* end;
+        long id = strtol(key, &end, 10);
+        if (end == key || *end != '\0' || id < 1 || id > MAX_WORKSPACES) return -1;
+        slot = &fmt->id_icon[id];
+    }
+
+    int offset = pool_add(fmt, icon, strlen(icon));
+    if (offset < 0) return -1;
+    *slot = (unsigned short)(offset + 1);
+    return 0;
+}
+
+// Append s, truncating at a UTF-8 character boundary if the label is full
+static void append(char* out, size_t* len, const char* s) {
+    size_t n = strlen(s);
+    if (*len + n >= LABEL_TEXT_MAX) {
+        n = LABEL_TEXT_MAX - 1 - *len;
+        while (n > 0 && ((unsigned char)s[n] & 0xC0) == 0x80) n--;
+    }
+    memcpy(out + *len, s, n);
+    *len += n;
+    out[*len] = '\0';
+}
+
+static const char* pick_icon(const LabelFormat* fmt, int workspace, unsigned classes) {
+    unsigned short icon = 0;
+    if (classes & WS_CLASS_ACTIVE) icon = fmt->state_icon[LABEL_ICON_ACTIVE];
+    if (!icon && (classes & WS_CLASS_VISIBLE)) icon = fmt->state_icon[LABEL_ICON_VISIBLE];
+    if (!icon && workspace >= 1 && workspace <= MAX_WORKSPACES) icon = fmt->id_icon[workspace];
+    if (!icon && (classes & WS_CLASS_EMPTY)) icon = fmt->state_icon[LABEL_ICON_EMPTY];
+    if (!icon) icon = fmt->state_icon[LABEL_ICON_DEFAULT];
+    return icon ? fmt->pool + icon - 1 : NULL;
+}
+
+int label_format_update(const LabelFormat* fmt, LabelCache* cache, int workspace,
+                        unsigned classes, int windows) {
+    // Inputs the format ignores can change freely
+    if (cache->valid &&
+        (!(fmt->inputs & LABEL_INPUT_ID) || cache->workspace == workspace) &&
+        (!(fmt->inputs & LABEL_INPUT_CLASSES) || cache->classes == classes) &&
+        (!(fmt->inputs & LABEL_INPUT_WINDOWS) || cache->windows == windows)) {
+        return 0;
+    }
+    cache->workspace = workspace;
+    cache->classes = classes;
+    cache->windows = windows;
+
+    char text[LABEL_TEXT_MAX];
+    char number[16];
+    size_t len = 0;
+    text[0] = '\0';
+    for (int i = 0; i < fmt->token_count; i++) {
+        const LabelToken* token = &fmt->tokens[i];
+        const char* icon;
+        switch (token->kind) {
+        case LABEL_TOKEN_TEXT:
+            append(text, &len, fmt->pool + token->offset);
+            break;
+        case LABEL_TOKEN_ID:
+            snprintf(number, sizeof(number), "%d", workspace);
+            append(text, &len, number);
+            break;
+        case LABEL_TOKEN_ICON:
+            icon = pick_icon(fmt, workspace, classes);
+            if (icon) {
+                append(text, &len, icon);
+            } else {
+                snprintf(number, sizeof(number), "%d", workspace);
+                append(text, &len, number);
+            }
+            break;
+        case LABEL_TOKEN_WINDOWS:
+            snprintf(number, sizeof(number), "%d", windows);
+            append(text, &len, number);
+            break;
+        }
+    }
+
+    if (cache->valid && strcmp(text, cache->text) == 0) return 0;
+    memcpy(cache->text, text, len + 1);
+    cache->valid = 1;
+    return 1;
+}
@@ -0,0 +1,90 @@
+/**
+ * Workspace label templates ("format" / "format-icons").
+ *
+ * A format such as "{icon} {windows}" is compiled once into a token list.
+ * Rendering a label goes through a per-slot LabelCache: the text is only
+ * rebuilt when an input the tokens actually use changed, and the caller is
+ * told whether the final text differs, so widgets are only relabelled (and
+ * Pango only re-measures) when what they show changes.
+ *
+ * Placeholders: {id}, {name} (the workspace name, which for the numbered
+ * workspaces handled here is the id), {icon}, {windows}. "{{" and "}}" are
+ * literal braces.
+ *
+ * {icon} picks, in order: the "active" or "visible" icon for the focused
+ * workspace, the icon keyed by the workspace id ("3"), the "empty" icon,
+ * the "default" icon, and finally the id itself.
+ *
+ * GTK-free.
+ */
+
+#pragma once
+
+#include "workspace_state.h"
+
+#define LABEL_TEXT_MAX 64            // Rendered label, including the terminator
+#define LABEL_FORMAT_TOKENS_MAX 16
+#define LABEL_FORMAT_POOL 256        // Literal text and icons, NUL-separated
+
+typedef enum {
+    LABEL_TOKEN_TEXT,
+    LABEL_TOKEN_ID,
+    LABEL_TOKEN_ICON,
+    LABEL_TOKEN_WINDOWS,
+} LabelTokenKind;
+
+typedef struct {
+    LabelTokenKind kind;
+    unsigned short offset;           // LABEL_TOKEN_TEXT: literal in the pool
+} LabelToken;
+
+// States with their own icon
+typedef enum {
+    LABEL_ICON_ACTIVE,
+    LABEL_ICON_VISIBLE,
+    LABEL_ICON_EMPTY,
+    LABEL_ICON_DEFAULT,
+    LABEL_ICON_STATE_COUNT,
+} LabelIconState;
+
+// Inputs a compiled format depends on
+enum {
+    LABEL_INPUT_ID = 1 << 0,
+    LABEL_INPUT_CLASSES = 1 << 1,
+    LABEL_INPUT_WINDOWS = 1 << 2,
+};
+
+typedef struct {
+    LabelToken tokens[LABEL_FORMAT_TOKENS_MAX];
+    int token_count;
+    unsigned inputs;                              // LABEL_INPUT_* bits
+
+    char pool[LABEL_FORMAT_POOL];
+    int pool_used;
+    unsigned short state_icon[LABEL_ICON_STATE_COUNT];  // Pool offset + 1, 0 if unset
+    unsigned short id_icon[MAX_WORKSPACES + 1];         // Pool offset + 1, 0 if unset
+} LabelFormat;
+
+// Last rendered label of one slot
+typedef struct {
+    int valid;
+    int workspace;
+    unsigned classes;
+    int windows;
+    char text[LABEL_TEXT_MAX];
+} LabelCache;
+
+// Default format "{id}", no icons
+void label_format_init(LabelFormat* fmt);
+
+// Compile a format string. Returns -1 (leaving fmt unchanged) for unknown
+// placeholders, unbalanced braces or a format too long to hold.
+int label_format_compile(LabelFormat* fmt, const char* format);
+
+// Set the icon for key: "active", "visible", "empty", "default" or a
+// workspace id. Returns -1 for other keys or when the pool is full.
+int label_format_set_icon(LabelFormat* fmt, const char* key, const char* icon);
+
+// Bring cache->text up to date for these inputs. Returns 1 if the text changed.
+int label_format_update(const LabelFormat* fmt, LabelCache* cache, int workspace,
+                        unsigned classes, int windows);
@@ -0,0 +1,256 @@
+/**
+ * Module configuration - see module_config.h
+ */
+
+#include "module_config.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Parse boolean config value from JSON string
+static int parse_bool(const char* value) {
+    if (!value) return 0;
+    // JSON booleans are "true" or "false"
+    if (strcmp(value, "true") == 0) return 1;
+    if (strcmp(value, "false") == 0) return 0;
+    // Also accept "1" / "0"
+    return atoi(value) != 0;
+}
+
+// Copy a JSON string value without its quotes (a bare string is taken as is)
+static void parse_string(const char* value, char* dest, size_t dest_size) {
+    if (value[0] == '"') value++;
+    strncpy(dest, value, dest_size - 1);
+    dest[dest_size - 1] = '\0';
+    size_t len = strlen(dest);
+    if (len > 0 && dest[len - 1] == '"') {
+        dest[len - 1] = '\0';
+    }
+}
+
+static const char* skip_ws(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    return p;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int parse_hex4(const char* p, uint32_t* out) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_digit(p[i]);
+        if (digit < 0) return -1;
+        value = value << 4 | (uint32_t)digit;
+    }
+    *out = value;
+    return 0;
+}
+
+// Decode the JSON string at p (its opening quote) into dest as UTF-8, escapes
+// included: Waybar's JSON writer may emit icons as \uXXXX surrogate pairs.
+// Returns the position after the closing quote, NULL if malformed or too long.
+static const char* decode_json_string(const char* p, char* dest, size_t dest_size) {
+    size_t len = 0;
+    if (*p++ != '"') return NULL;
+    while (*p != '"') {
+        char utf8[4];
+        size_t n = 1;
+        if (*p == '\0') return NULL;
+        if (*p != '\\') {
+            utf8[0] = *p++;
+        } else {
+            p++;
+            switch (*p++) {
+            case '"': utf8[0] = '"'; break;
+            case '\\': utf8[0] = '\\'; break;
+            case '/': utf8[0] = '/'; break;
+            case 'b': utf8[0] = '\b'; break;
+            case 'f': utf8[0] = '\f'; break;
+            case 'n': utf8[0] = '\n'; break;
+            case 'r': utf8[0] = '\r'; break;
+            case 't': utf8[0] = '\t'; break;
+            case 'u': {
+                uint32_t cp, low;
+                if (parse_hex4(p, &cp) < 0) return NULL;
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    if (p[0] != '\\' || p[1] != 'u' || parse_hex4(p + 2, &low) < 0 ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        return NULL;
+                    }
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (cp == 0) return NULL;
+                if (cp < 0x80) {
+                    utf8[0] = (char)cp;
+                } else if (cp < 0x800) {
+                    utf8[0] = (char)(0xC0 | cp >> 6);
+                    utf8[1] = (char)(0x80 | (cp & 0x3F));
+                    n = 2;
+                } else if (cp < 0x10000) {
+                    utf8[0] = (char)(0xE0 | cp >> 12);
+                    utf8[1] = (char)(0x80 | (cp >> 6 & 0x3F));
+                    utf8[2] = (char)(0x80 | (cp & 0x3F));
+                    n = 3;
+                } else {
+                    utf8[0] = (char)(0xF0 | cp >> 18);
+                    utf8[1] = (char)(0x80 | (cp >> 12 & 0x3F));
+                    utf8[2] = (char)(0x80 | (cp >> 6 & 0x3F));
+                    utf8[3] = (char)(0x80 | (cp & 0x3F));
+                    n = 4;
+                }
+                break;
+            }
+            default:
+                return NULL;
+            }
+        }
+        if (len + n >= dest_size) return NULL;
+        memcpy(dest + len, utf8, n);
+        len += n;
+    }
+    dest[len] = '\0';
+    return p + 1;
+}
+
+// format-icons: a JSON object of strings. Keys the label engine doesn't
+// know are skipped, so configs shared with Waybar's own module still load.
+// A bad object leaves the icons as they were.
+static int parse_format_icons(LabelFormat* label, const char* value) {
+    LabelFormat parsed = *label;
+    char key[32];
+    char icon[LABEL_TEXT_MAX];
+    const char* p = skip_ws(value);
+
+    if (*p++ != '{') return -1;
+    p = skip_ws(p);
+    while (*p != '}') {
+        p = decode_json_string(skip_ws(p), key, sizeof(key));
+        if (!p) return -1;
+        p = skip_ws(p);
+        if (*p++ != ':') return -1;
+        p = decode_json_string(skip_ws(p), icon, sizeof(icon));
+        if (!p) return -1;
+        label_format_set_icon(&parsed, key, icon);
+
+        p = skip_ws(p);
+        if (*p == '}') break;
+        if (*p++ != ',') return -1;
+        p = skip_ws(p);
+        if (*p == '}') return -1;
+    }
+
+    *label = parsed;
+    return 0;
+}
+
+// badge-thresholds: a JSON array of ascending positive counts, at most
+// WS_COUNT_LEVELS_MAX. Each gets a "windows-N" class name. A bad array
+// leaves the thresholds as they were.
+static int parse_thresholds(ModuleConfig* config, const char* value) {
+    int levels[WS_COUNT_LEVELS_MAX] = { 0 };
+    int count = 0;
+    const char* p = skip_ws(value);
+
+    if (*p++ != '[') return -1;
+    p = skip_ws(p);
+    while (*p != ']') {
+        char* end;
+        long level = strtol(p, &end, 10);
+        if (end == p || level < 1 || level > 9999 || count == WS_COUNT_LEVELS_MAX) return -1;
+        if (count > 0 && level <= levels[count - 1]) return -1;
+        levels[count++] = (int)level;
+        p = skip_ws(end);
+        if (*p == ',') {
+            p = skip_ws(p + 1);
+        } else if (*p != ']') {
+            return -1;
+        }
+    }
+
+    memcpy(config->view.count_levels, levels, sizeof(levels));
+    config->view.count_level_count = count;
+    for (int i = 0; i < count; i++) {
+        snprintf(config->count_classes[i], sizeof(config->count_classes[i]), "windows-%d", levels[i]);
+    }
+    return 0;
+}
+
+void module_config_init(ModuleConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->view.all_outputs = 0;  // Only show workspaces on this monitor
+    config->view.show_empty = 0;   // Hide empty workspaces
+    config->reconcile_interval = DEFAULT_RECONCILE_INTERVAL;
+    config->render_mode = RENDER_MODE_BUTTONS;
+    config->stable_layout = 0;
+    config->max_visible = 0;
+    label_format_init(&config->label);
+    config->app_icon_size = DEFAULT_APP_ICON_SIZE;
+    config->tooltip = 1;
+    config->badges = 0;
+    config->urgent_blink = 0;
+}
+
+int module_config_set(ModuleConfig* config, const char* key, const char* value) {
+    if (!value) return -1;
+
+    if (strcmp(key, "all-outputs") == 0) {
+        config->view.all_outputs = parse_bool(value);
+    } else if (strcmp(key, "show-empty") == 0) {
+        config->view.show_empty = parse_bool(value);
+    } else if (strcmp(key, "reconcile-interval") == 0) {
+        config->reconcile_interval = atoi(value);
+        if (config->reconcile_interval < 0) config->reconcile_interval = 0;
+    } else if (strcmp(key, "output") == 0) {
+        // Allow manual override of output name
+        parse_string(value, config->output, sizeof(config->output));
+    } else if (strcmp(key, "render-mode") == 0) {
+        char mode[16];
+        parse_string(value, mode, sizeof(mode));
+        if (strcmp(mode, "buttons") == 0) {
+            config->render_mode = RENDER_MODE_BUTTONS;
+        } else if (strcmp(mode, "strip") == 0) {
+            config->render_mode = RENDER_MODE_STRIP;
+        } else {
+            return -1;
+        }
+    } else if (strcmp(key, "stable-layout") == 0) {
+        config->stable_layout = parse_bool(value);
+    } else if (strcmp(key, "max-visible") == 0) {
+        config->max_visible = atoi(value);
+        if (config->max_visible < 0) config->max_visible = 0;
+        if (config->max_visible > MAX_WORKSPACES) config->max_visible = MAX_WORKSPACES;
+    } else if (strcmp(key, "has-floating") == 0) {
+        config->view.has_floating = parse_bool(value);
+    } else if (strcmp(key, "app-icons") == 0) {
+        config->view.app_icons = parse_bool(value);
+    } else if (strcmp(key, "app-icon-size") == 0) {
+        config->app_icon_size = atoi(value);
+        if (config->app_icon_size < MIN_APP_ICON_SIZE) config->app_icon_size = MIN_APP_ICON_SIZE;
+        if (config->app_icon_size > MAX_APP_ICON_SIZE) config->app_icon_size = MAX_APP_ICON_SIZE;
+    } else if (strcmp(key, "badges") == 0) {
+        config->badges = parse_bool(value);
+    } else if (strcmp(key, "badge-thresholds") == 0) {
+        return parse_thresholds(config, value);
+    } else if (strcmp(key, "urgent-blink") == 0) {
+        config->urgent_blink = parse_bool(value);
+    } else if (strcmp(key, "tooltip") == 0) {
+        config->tooltip = parse_bool(value);
+    } else if (strcmp(key, "format") == 0) {
+        char format[LABEL_FORMAT_POOL];
+        if (!decode_json_string(value, format, sizeof(format))) return -1;
+        return label_format_compile(&config->label, format);
+    } else if (strcmp(key, "format-icons") == 0) {
+        return parse_format_icons(&config->label, value);
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * Module configuration parsed from Waybar's config entries.
+ *
+ * Kept apart from wbcffi_init() so it can be tested without GTK. Values use
+ * the CFFI ABI v2 encoding: the JSON representation of the value.
+ */
+
+#pragma once
+
+#include "label_format.h"
+#include "workspace_state.h"
+
+// Background reconcile against `hyprctl workspaces -j` / `clients -j` (seconds, 0 disables)
+#define DEFAULT_RECONCILE_INTERVAL 60
+
+// App icon size in logical pixels, and the accepted range
+#define DEFAULT_APP_ICON_SIZE 16
+#define MIN_APP_ICON_SIZE 8
+#define MAX_APP_ICON_SIZE 128
+
+// How the workspace buttons are drawn
+typedef enum {
+    RENDER_MODE_BUTTONS,   // A GtkButton subtree per workspace (default)
+    RENDER_MODE_STRIP,     // One custom-drawn widget for the whole strip
+} RenderMode;
+
+typedef struct {
+    WorkspaceViewConfig view;           // all-outputs / show-empty / app-icons / has-floating
+    int reconcile_interval;             // Seconds between background reconciles, 0 = off
+    char output[MONITOR_NAME_MAX];      // Monitor override, "" to detect
+    RenderMode render_mode;
+    int stable_layout;                  // Hidden buttons keep their space, no bar relayout
+    int max_visible;                    // Buttons in the scrollable window, 0 = all
+    LabelFormat label;                  // format / format-icons
+    int app_icon_size;
+    int tooltip;                        // Window list tooltips on hover
+    int badges;                         // Window count badges
+    char count_classes[WS_COUNT_LEVELS_MAX][16];  // "windows-N" per badge threshold
+    int urgent_blink;                   // Toggle "blink" on urgent workspaces
+} ModuleConfig;
+
+// Defaults: this monitor only, hide empty workspaces, detect the monitor,
+// button widgets that collapse when hidden, no scrolling, "{id}" labels,
+// window list tooltips, no badges or count thresholds, no urgent blinking
+void module_config_init(ModuleConfig* config);
+
+// Apply one config entry. Returns -1 for keys the module doesn't know.
+int module_config_set(ModuleConfig* config, const char* key, const char* value);
@@ -0,0 +1,164 @@
+/**
+ * Button slot pool - see slot_pool.h
+ */
+
+#include "slot_pool.h"
+#include <string.h>
+
+void slot_pool_init(SlotPool* pool) {
+    memset(pool, 0, sizeof(*pool));
+    for (int i = 0; i <= MAX_WORKSPACES; i++) {
+        pool->slot_of[i] = -1;
+    }
+}
+
+// A slot that is not needed this update: prefer never-bound ones, then those
+// of workspaces not shown any more. The cursors carry over between calls in
+// one update; returns -1 when there is none.
+static int take_spare(SlotPool* pool, int* next_free, int* next_stale) {
+    for (; *next_free < pool->count; (*next_free)++) {
+        if (pool->slot_workspace[*next_free] == 0) return (*next_free)++;
+    }
+    for (; *next_stale < pool->count; (*next_stale)++) {
+        int workspace = pool->slot_workspace[*next_stale];
+        if (workspace != 0 && pool->stamp[workspace] != pool->generation) return (*next_stale)++;
+    }
+    return -1;
+}
+
+// Move slot to position `to` with gtk_box_reorder_child() semantics
+static void move_slot(SlotPool* pool, int slot, int to) {
+    int from = pool->position[slot];
+
+    if (from < to) {
+        memmove(&pool->order[from], &pool->order[from + 1], (size_t)(to - from) * sizeof(int));
+    } else {
+        memmove(&pool->order[to + 1], &pool->order[to], (size_t)(from - to) * sizeof(int));
+    }
+    pool->order[to] = slot;
+
+    int lo = from < to ? from : to;
+    int hi = from < to ? to : from;
+    for (int p = lo; p <= hi; p++) {
+        pool->position[pool->order[p]] = p;
+    }
+    pool->moves++;
+}
+
+// Sort key of a slot: its workspace, unbound slots last
+static int slot_key(const SlotPool* pool, int slot) {
+    int workspace = pool->slot_workspace[slot];
+    return workspace ? workspace : MAX_WORKSPACES + 1 + slot;
+}
+
+// Put every slot, shown or hidden, in workspace order. Slots on a longest
+// already ordered subsequence stay; each other one moves once, right behind
+// the slot before it in that order.
+static void order_all_slots(SlotPool* pool, const SlotPoolOps* ops, void* user_data) {
+    int n = pool->count;
+    int run[MAX_WORKSPACES];    // Position -> length of the longest ordered run ending there
+    int prev[MAX_WORKSPACES];   // Position -> previous position of that run, -1 at its start
+    unsigned char stays[MAX_WORKSPACES] = { 0 };
+    int sorted[MAX_WORKSPACES];
+    int end = -1;
+
+    for (int p = 0; p < n; p++) {
+        int key = slot_key(pool, pool->order[p]);
+        run[p] = 1;
+        prev[p] = -1;
+        for (int q = 0; q < p; q++) {
+            if (slot_key(pool, pool->order[q]) < key && run[q] + 1 > run[p]) {
+                run[p] = run[q] + 1;
+                prev[p] = q;
+            }
+        }
+        if (end < 0 || run[p] > run[end]) end = p;
+    }
+    for (int p = end; p >= 0; p = prev[p]) {
+        stays[pool->order[p]] = 1;
+    }
+
+    for (int slot = 0; slot < n; slot++) {
+        int i = slot;
+        for (; i > 0 && slot_key(pool, sorted[i - 1]) > slot_key(pool, slot); i--) {
+            sorted[i] = sorted[i - 1];
+        }
+        sorted[i] = slot;
+    }
+    for (int i = 0; i < n; i++) {
+        int slot = sorted[i];
+        if (stays[slot]) continue;
+        int to = 0;
+        if (i > 0) {
+            int after = pool->position[sorted[i - 1]];
+            to = pool->position[slot] < after ? after : after + 1;
+        }
+        if (to == pool->position[slot]) continue;
+        move_slot(pool, slot, to);
+        ops->move(user_data, slot, to);
+    }
+}
+
+void slot_pool_update(SlotPool* pool, const int* workspaces, int count,
+                      const SlotPoolOps* ops, void* user_data) {
+    int next_free = 0;
+    int next_stale = 0;
+    int last = -1;  // Position of the previous shown slot
+
+    // Mark what is shown this time, so stale slots can be recognised
+    pool->generation++;
+    for (int i = 0; i < count; i++) {
+        pool->stamp[workspaces[i]] = pool->generation;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int workspace = workspaces[i];
+        int slot = pool->slot_of[workspace];
+
+        if (slot < 0) {
+            slot = take_spare(pool, &next_free, &next_stale);
+            if (slot < 0) {
+                slot = pool->count++;
+                pool->order[slot] = slot;
+                pool->position[slot] = slot;
+                pool->slot_workspace[slot] = 0;
+                pool->created++;
+                ops->create(user_data, slot);
+            }
+            if (pool->slot_workspace[slot] != 0) {
+                pool->slot_of[pool->slot_workspace[slot]] = -1;
+            }
+            pool->slot_workspace[slot] = workspace;
+            pool->slot_of[workspace] = (short)slot;
+            pool->rebinds++;
+            ops->bind(user_data, slot, workspace);
+        }
+
+        // Hidden slots in between don't matter; only move a slot that sits
+        // before the previous shown one (with keep_space all are ordered below)
+        if (pool->keep_space) {
+            continue;
+        } else if (pool->position[slot] < last) {
+            move_slot(pool, slot, last);
+            ops->move(user_data, slot, last);
+        } else {
+            last = pool->position[slot];
+        }
+    }
+    if (pool->keep_space) {
+        order_all_slots(pool, ops, user_data);
+    }
+}
+
+int slot_pool_shown(const SlotPool* pool, int slot) {
+    int workspace = pool->slot_workspace[slot];
+    return workspace != 0 && pool->stamp[workspace] == pool->generation;
+}
+
+int slot_window_first(int first, int count, int visible, int keep) {
+    if (visible >= count) return 0;
+    if (keep >= 0 && keep < first) first = keep;
+    if (keep >= 0 && keep >= first + visible) first = keep - visible + 1;
+    if (first > count - visible) first = count - visible;
+    return first < 0 ? 0 : first;
+}
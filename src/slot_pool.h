@@ -0,0 +1,64 @@
+/**
+ * Recycled button slots for a changing, ordered set of workspaces.
+ *
+ * The UI keeps one slot (button subtree) per workspace it has shown, in a
+ * container whose child order is the slot order. Each update binds the
+ * workspaces to be shown, in order, to slots: a workspace keeps the slot it
+ * had, a new one takes a spare slot (unbound, or bound to a workspace that
+ * is gone), and only when there is no spare is a slot created. A slot is
+ * moved only when it sits before the previous shown one: hidden slots take
+ * no space, so only the relative order of shown slots matters. The UI hides
+ * every slot slot_pool_shown() rejects.
+ *
+ * With keep_space (stable-layout) hidden slots do take space, so every slot,
+ * shown or not, is kept in workspace id order instead.
+ *
+ * With more workspaces than fit, only a window of them is bound at all
+ * (slot_window_first()), so the number of slots and the work per update
+ * are bounded by the window, not by the workspace count.
+ *
+ * GTK-free: the widget work happens in the callbacks.
+ */
+
+#pragma once
+
+#include "workspace_state.h"
+
+typedef struct {
+    // Append a new slot at position `slot` (the current slot count)
+    void (*create)(void* user_data, int slot);
+    // Slot now shows workspace (label etc. must be updated)
+    void (*bind)(void* user_data, int slot, int workspace);
+    // Move slot to position, like gtk_box_reorder_child()
+    void (*move)(void* user_data, int slot, int position);
+} SlotPoolOps;
+
+typedef struct {
+    int count;                               // Slots created so far
+    int slot_workspace[MAX_WORKSPACES];      // Slot -> workspace id, 0 if unbound
+    int order[MAX_WORKSPACES];               // Position -> slot
+    int position[MAX_WORKSPACES];            // Slot -> position
+    short slot_of[MAX_WORKSPACES + 1];       // Workspace id -> slot, -1 if none
+    unsigned stamp[MAX_WORKSPACES + 1];      // Workspace id -> last update it was shown in
+    unsigned generation;
+    int keep_space;                          // Hidden slots take space: order all by workspace
+
+    unsigned long created;                   // Slots created
+    unsigned long rebinds;                   // Slots bound to a different workspace
+    unsigned long moves;                     // Slots moved
+} SlotPool;
+
+void slot_pool_init(SlotPool* pool);
+
+// Bind workspaces[0, count) (ids 1..MAX_WORKSPACES, in display order, which
+// with keep_space must be ascending) to slots in that relative order, calling
+// ops as needed
+void slot_pool_update(SlotPool* pool, const int* workspaces, int count,
+                      const SlotPoolOps* ops, void* user_data);
+
+// Whether slot is bound to a workspace shown by the last update
+int slot_pool_shown(const SlotPool* pool, int slot);
+
+// Start of a window of `visible` out of count entries: first, moved as little
+// as needed to stay in range and, if keep >= 0, to contain entry keep
+int slot_window_first(int first, int count, int visible, int keep);
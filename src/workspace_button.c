@@ -0,0 +1,177 @@
+/**
+ * Widget-tree workspace button - see workspace_button.h
+ */
+
+#include "workspace_button.h"
+#include "workspace_state.h"
+#include <stdio.h>
+#include <string.h>
+
+void workspace_button_init(WorkspaceButton* button, const char* label, const char* dot_color) {
+    // Create button with overlay structure for proper dot positioning
+    button->button = GTK_BUTTON(gtk_button_new());
+    GtkOverlay* overlay = GTK_OVERLAY(gtk_overlay_new());
+
+    // Main label (centered number)
+    button->label = GTK_LABEL(gtk_label_new(label));
+    gtk_widget_set_halign(GTK_WIDGET(button->label), GTK_ALIGN_CENTER);
+    gtk_widget_set_valign(GTK_WIDGET(button->label), GTK_ALIGN_CENTER);
+    gtk_container_add(GTK_CONTAINER(overlay), GTK_WIDGET(button->label));
+
+    // Dot indicator (positioned top-right, initially hidden)
+    char dot_markup[64];
+    snprintf(dot_markup, sizeof(dot_markup),
+             "<span font_size='5000' color='%s'>●</span>", dot_color);
+    button->dot = GTK_LABEL(gtk_label_new(NULL));
+    gtk_label_set_markup(button->dot, dot_markup);
+    gtk_widget_set_halign(GTK_WIDGET(button->dot), GTK_ALIGN_END);
+    gtk_widget_set_valign(GTK_WIDGET(button->dot), GTK_ALIGN_START);
+    gtk_widget_set_no_show_all(GTK_WIDGET(button->dot), TRUE);
+    gtk_overlay_add_overlay(overlay, GTK_WIDGET(button->dot));
+
+    gtk_container_add(GTK_CONTAINER(button->button), GTK_WIDGET(overlay));
+
+    gtk_button_set_relief(button->button, GTK_RELIEF_NONE);
+    gtk_widget_set_can_focus(GTK_WIDGET(button->button), FALSE);
+
+    button->apps = NULL;
+    button->app_count = 0;
+    memset(button->app_images, 0, sizeof(button->app_images));
+    memset(button->app_surfaces, 0, sizeof(button->app_surfaces));
+    memset(button->badges, 0, sizeof(button->badges));
+    memset(button->badge_counts, 0, sizeof(button->badge_counts));
+    button->count_class = NULL;
+    button->blink = 0;
+    button->workspace = 0;
+    button->shown = 1;
+    button->keep_space = 0;
+    button->classes = 0;
+}
+
+void workspace_button_enable_apps(WorkspaceButton* button) {
+    GtkWidget* label = GTK_WIDGET(button->label);
+    GtkContainer* overlay = GTK_CONTAINER(gtk_widget_get_parent(label));
+
+    // The overlay's main child becomes a centred row: label, then icons
+    GtkWidget* row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+    gtk_widget_set_halign(row, GTK_ALIGN_CENTER);
+    gtk_widget_set_valign(row, GTK_ALIGN_CENTER);
+    g_object_ref(label);
+    gtk_container_remove(overlay, label);
+    gtk_box_pack_start(GTK_BOX(row), label, FALSE, FALSE, 0);
+    g_object_unref(label);
+
+    button->apps = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
+    gtk_style_context_add_class(gtk_widget_get_style_context(GTK_WIDGET(button->apps)), "apps");
+    gtk_box_pack_start(GTK_BOX(row), GTK_WIDGET(button->apps), FALSE, FALSE, 0);
+    gtk_container_add(overlay, row);
+}
+
+void workspace_button_set_apps(WorkspaceButton* button, cairo_surface_t* const* surfaces, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!button->app_images[i]) {
+            button->app_images[i] = GTK_IMAGE(gtk_image_new());
+            gtk_box_pack_start(button->apps, GTK_WIDGET(button->app_images[i]), FALSE, FALSE, 0);
+        }
+        if (button->app_surfaces[i] != surfaces[i]) {
+            gtk_image_set_from_surface(button->app_images[i], surfaces[i]);
+            button->app_surfaces[i] = surfaces[i];
+        }
+        if (i >= button->app_count) gtk_widget_show(GTK_WIDGET(button->app_images[i]));
+    }
+    for (int i = count; i < button->app_count; i++) {
+        gtk_widget_hide(GTK_WIDGET(button->app_images[i]));
+    }
+    button->app_count = count;
+}
+
+void workspace_button_enable_badges(WorkspaceButton* button) {
+    GtkOverlay* overlay = GTK_OVERLAY(gtk_widget_get_parent(GTK_WIDGET(button->dot)));
+    for (int i = 0; i < 2; i++) {
+        button->badges[i] = GTK_LABEL(gtk_label_new(NULL));
+        GtkWidget* badge = GTK_WIDGET(button->badges[i]);
+        GtkStyleContext* ctx = gtk_widget_get_style_context(badge);
+        gtk_style_context_add_class(ctx, "badge");
+        if (i == 1) gtk_style_context_add_class(ctx, "special");
+        gtk_widget_set_halign(badge, i == 0 ? GTK_ALIGN_END : GTK_ALIGN_START);
+        gtk_widget_set_valign(badge, GTK_ALIGN_END);
+        gtk_widget_set_no_show_all(badge, TRUE);
+        gtk_overlay_add_overlay(overlay, badge);
+    }
+}
+
+void workspace_button_set_counts(WorkspaceButton* button, int windows, int special,
+                                 const char* count_class) {
+    if (count_class != button->count_class) {
+        GtkStyleContext* ctx = gtk_widget_get_style_context(GTK_WIDGET(button->button));
+        if (button->count_class) gtk_style_context_remove_class(ctx, button->count_class);
+        if (count_class) gtk_style_context_add_class(ctx, count_class);
+        button->count_class = count_class;
+    }
+
+    if (!button->badges[0]) return;
+    int counts[2] = { windows, special };
+    for (int i = 0; i < 2; i++) {
+        if (counts[i] == button->badge_counts[i]) continue;
+        if (counts[i] > 0) {
+            char text[16];
+            snprintf(text, sizeof(text), "%d", counts[i]);
+            gtk_label_set_text(button->badges[i], text);
+        }
+        if ((counts[i] > 0) != (button->badge_counts[i] > 0)) {
+            gtk_widget_set_visible(GTK_WIDGET(button->badges[i]), counts[i] > 0);
+        }
+        button->badge_counts[i] = counts[i];
+    }
+}
+
+void workspace_button_set_blink(WorkspaceButton* button, int blink) {
+    if (blink == button->blink) return;
+    GtkStyleContext* ctx = gtk_widget_get_style_context(GTK_WIDGET(button->button));
+    if (blink) {
+        gtk_style_context_add_class(ctx, "blink");
+    } else {
+        gtk_style_context_remove_class(ctx, "blink");
+    }
+    button->blink = blink;
+}
+
+void workspace_button_set_label(WorkspaceButton* button, const char* label) {
+    // A changed text queues a resize, so skip no-op updates
+    if (strcmp(gtk_label_get_text(button->label), label) != 0) {
+        gtk_label_set_text(button->label, label);
+    }
+}
+
+void workspace_button_apply(WorkspaceButton* button, int shown, unsigned classes) {
+    if (shown != button->shown) {
+        // Visibility changes queue a resize of the whole bar; opacity doesn't
+        if (button->keep_space) {
+            gtk_widget_set_opacity(GTK_WIDGET(button->button), shown ? 1.0 : 0.0);
+        } else {
+            gtk_widget_set_visible(GTK_WIDGET(button->button), shown);
+        }
+        button->shown = shown;
+    }
+    if (!shown) return;
+
+    unsigned changed = classes ^ button->classes;
+    if (!changed) return;
+
+    GtkStyleContext* ctx = gtk_widget_get_style_context(GTK_WIDGET(button->button));
+    for (int i = 0; i < WS_CLASS_COUNT; i++) {
+        unsigned bit = 1u << i;
+        if (!(changed & bit)) continue;
+        if (classes & bit) {
+            gtk_style_context_add_class(ctx, ws_class_names[i]);
+        } else {
+            gtk_style_context_remove_class(ctx, ws_class_names[i]);
+        }
+    }
+
+    // Show/hide dot indicator (separate overlay, doesn't affect centering)
+    if (changed & WS_CLASS_HAS_SPECIAL) {
+        gtk_widget_set_visible(GTK_WIDGET(button->dot), (classes & WS_CLASS_HAS_SPECIAL) != 0);
+    }
+    button->classes = classes;
+}
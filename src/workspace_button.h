@@ -0,0 +1,64 @@
+/**
+ * One workspace button of the widget-tree render mode: a GtkButton holding
+ * a GtkOverlay with the centred number label and the special-workspace dot.
+ * Buttons are pooled and rebound to whichever workspace needs one. With app
+ * icons the label shares a row with a box of GtkImages, one per class. Window
+ * count badges are overlay labels in the bottom corners, so they never
+ * change the button's size.
+ *
+ * Classes are applied as a diff against what the button already carries, so
+ * a commit that leaves a button alone costs no style invalidation.
+ */
+
+#pragma once
+
+#include "workspace_state.h"
+#include <gtk/gtk.h>
+
+typedef struct {
+    int workspace;       // Bound workspace id, 0 if none
+    GtkButton* button;
+    GtkLabel* label;
+    GtkLabel* dot;       // Special-workspace indicator, top-right
+    int shown;
+    int keep_space;      // Hide by making the button transparent, keeping its allocation
+    unsigned classes;    // WS_CLASS_* bits currently on the button
+
+    GtkBox* apps;        // App icons after the label, NULL unless enabled
+    GtkImage* app_images[WS_APPS_MAX];         // Created on first use
+    cairo_surface_t* app_surfaces[WS_APPS_MAX]; // What each image shows (it holds the reference)
+    int app_count;       // Images shown
+
+    GtkLabel* badges[2]; // Regular / special window count, NULL unless enabled
+    int badge_counts[2]; // What each badge shows, 0 when hidden
+    const char* count_class;  // "windows-N" class on the button, NULL if none
+    int blink;           // "blink" class on the button (urgent-blink on phase)
+} WorkspaceButton;
+
+// Build the subtree; dot_color is the indicator's CSS colour ("#rrggbb")
+void workspace_button_init(WorkspaceButton* button, const char* label, const char* dot_color);
+
+// Add the app icon box next to the label; call before the button is shown
+void workspace_button_enable_apps(WorkspaceButton* button);
+
+// Show surfaces[0, count) as app icons, touching only images that change
+void workspace_button_set_apps(WorkspaceButton* button, cairo_surface_t* const* surfaces, int count);
+
+// Add the window count badges (bottom-right: regular, bottom-left: special)
+void workspace_button_enable_badges(WorkspaceButton* button);
+
+// Show the window counts (badges hide at 0; ignored unless enabled) and move
+// the button to count_class (NULL for none). count_class strings must outlive
+// the button; they are compared by pointer.
+void workspace_button_set_counts(WorkspaceButton* button, int windows, int special,
+                                 const char* count_class);
+
+// Add or remove the "blink" class
+void workspace_button_set_blink(WorkspaceButton* button, int blink);
+
+// Set the label text, leaving the label alone if it already reads that
+void workspace_button_set_label(WorkspaceButton* button, const char* label);
+
+// Show/hide the button and bring its CSS classes and dot up to date. With
+// keep_space a hidden button stays in the layout, so hiding it only repaints.
+void workspace_button_apply(WorkspaceButton* button, int shown, unsigned classes);
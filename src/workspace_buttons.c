@@ -7,99 +7,140 @@
  * - Per-monitor filtering (configurable)
  * - Special workspace dot indicator (has-special class + visual dot)
  * - Click to switch workspace
- * - Real-time updates via Hyprland IPC socket
+ * - Real-time updates via Hyprland IPC socket, applied at most once per frame
  *
  * Config options:
  *   all-outputs: bool (default: false) - Show workspaces from all monitors
  *   show-empty: bool (default: false) - Show empty workspaces
+ *   reconcile-interval: int (default: 60) - Seconds between drift checks, 0 disables
+ *   render-mode: "buttons" (default) or "strip" - Widget tree or one custom-drawn strip
+ *   stable-layout: bool (default: false) - Hidden buttons keep their space (no bar relayout)
+ *   max-visible: int (default: 0) - Show a window of this many buttons, scrolled with the wheel
+ *   format: string (default: "{id}") - Label template: {id}, {name}, {icon}, {windows}
+ *   format-icons: object - {icon} per state ("active", "visible", "empty", "default") or id
+ *   app-icons: bool (default: false) - Icons of the window classes on each workspace
+ *   app-icon-size: int (default: 16) - App icon size in pixels
+ *   tooltip: bool (default: true) - Hovering a workspace lists its windows
+ *   badges: bool (default: false) - Regular / special window count badges
+ *   badge-thresholds: int array (default: []) - "windows-N" class once N windows are open
+ *   urgent-blink: bool (default: false) - Toggle a "blink" class on urgent workspaces
+ *   has-floating: bool (default: false) - "has-floating" class on workspaces with floating windows
+ *
+ * Actions:
+ *   stats - Print runtime counters to stderr
  */
 
 #include "waybar_cffi_module.h"
+#include "app_icons.h"
+#include "blink_timer.h"
+#include "command.h"
+#include "ipc_client.h"
+#include "module_config.h"
+#include "slot_pool.h"
+#include "workspace_button.h"
+#include "workspace_state.h"
+#include "workspace_strip.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
-#include <sys/socket.h>
-#include <sys/un.h>
-#include <pthread.h>
 
-#define NUM_WORKSPACES 9
 #define DEFAULT_TERTIARY_COLOR "#adc8f8"
 
+// Module lifecycle, only changed from the GTK main thread:
+// CREATED -> DETECTING -> RUNNING <-> SUSPENDED, any state -> STOPPING
+typedef enum {
+    LIFECYCLE_CREATED,    // Widgets built, waiting for the first map
+    LIFECYCLE_DETECTING,  // Monitor detection scheduled
+    LIFECYCLE_RUNNING,    // IPC thread started, widget mapped
+    LIFECYCLE_SUSPENDED,  // IPC thread started, widget unmapped (bar hidden)
+    LIFECYCLE_STOPPING,   // wbcffi_deinit in progress
+} ModuleLifecycle;
+
+// App icons a button / strip slot shows, to skip unchanged ones
+typedef struct {
+    int valid;
+    AppClassId apps[WS_APPS_MAX];
+    int count;
+    int scale;
+    unsigned generation;         // app_icon_generation() when looked up
+} AppSlot;
+
 typedef struct {
     wbcffi_module* waybar_module;
     const wbcffi_init_info* init_info;
     GtkBox* container;
-    GtkButton* buttons[NUM_WORKSPACES];
-    GtkLabel* labels[NUM_WORKSPACES];
-    GtkLabel* dot_labels[NUM_WORKSPACES];  // Separate dot indicators
+
+    // One of these is used, depending on config.render_mode. Buttons are
+    // created on demand and recycled as workspaces come and go.
+    WorkspaceButton buttons[MAX_WORKSPACES];
+    SlotPool pool;
+    WorkspaceStrip strip;
+    LabelCache labels[MAX_WORKSPACES];  // Last label per button / strip slot
+    AppSlot app_slots[MAX_WORKSPACES];  // Last app icons per button / strip slot
 
     // Configuration
-    int all_outputs;      // Show workspaces from all monitors
-    int show_empty;       // Show empty workspaces
+    ModuleConfig config;
 
     // Tertiary color for dot indicator
     char tertiary_color[16];
 
-    // Monitor name for this waybar instance
-    char monitor_name[64];
-
-    // State
-    int this_monitor_workspace;  // Workspace displayed on THIS module's monitor
-    int user_focused_here;       // Is user focused on THIS monitor?
-    int workspace_windows[NUM_WORKSPACES];    // Window count per workspace
-    int special_windows[NUM_WORKSPACES];      // Window count per special:N
-    char workspace_monitor[NUM_WORKSPACES][64]; // Monitor name per workspace
-
-    // Thread for IPC monitoring
-    pthread_t ipc_thread;
-    volatile int running;
-    int socket_fd;
+    // Hyprland IPC threads and the workspace model they maintain
+    IpcClient ipc;
+
+    // Lifecycle
+    ModuleLifecycle lifecycle;
+    guint detect_source;         // Pending detect_monitor_idle source, 0 if none
+    GSource* ui_source;          // Persistent UI update source, made ready by the worker
+
+    // Frame-aligned UI commits: the UI source only marks the widgets dirty and
+    // requests a frame; the update runs in the toplevel's before-paint phase
+    GdkFrameClock* frame_clock;  // While realized, NULL otherwise
+    gulong before_paint_handler;
+    int ui_dirty;
+    unsigned long ui_requests;   // Commits that reached the UI thread
+    unsigned long ui_passes;     // update_button_states() runs
+
+    // Size allocations of the container, and those where its size changed
+    // (i.e. the module made the bar relayout)
+    unsigned long size_allocs;
+    unsigned long resizes;
+    int alloc_width, alloc_height;
+
+    // max-visible window over the shown workspaces: only these get a slot
+    int view_first;              // Index of the first windowed workspace
+    int view_count;              // Shown workspaces at the last update
+    int view_active;             // Active workspace the window last followed
+    double scroll_delta;         // Smooth scrolling not yet turned into steps
+
+    // Window list tooltip: built in query-tooltip from the window table, and
+    // only rebuilt when the hovered workspace's windows or titles changed
+    WindowListCache tooltip;
+    GtkWidget* tooltip_widget;   // Widget whose tooltip is open, NULL if none
+
+    // urgent-blink: subscribed to the shared blink timer while a shown
+    // workspace is urgent
+    BlinkSubscriber blink;
 } WorkspaceModule;
 
+// UI update source, created once per module: the worker marks it ready
+// instead of allocating an idle source for every commit
+typedef struct {
+    GSource source;
+    WorkspaceModule* mod;
+} UiSource;
+
 const size_t wbcffi_version = 2;
 
 // Forward declarations
 static void update_button_states(WorkspaceModule* mod);
-static void* ipc_monitor_thread(void* arg);
 static void on_button_clicked(GtkButton* button, gpointer user_data);
-static void fetch_initial_state(WorkspaceModule* mod);
+static void on_strip_clicked(int workspace, void* user_data);
+static gboolean on_button_query_tooltip(GtkWidget* widget, gint x, gint y, gboolean keyboard,
+                                        GtkTooltip* tooltip, gpointer user_data);
+static gboolean on_tooltip_hidden(GtkWidget* widget, GdkEvent* event, gpointer user_data);
+static void connect_tooltip_hidden(GtkWidget* widget, WorkspaceModule* mod);
 static void load_tertiary_color(WorkspaceModule* mod);
 static gboolean detect_monitor_idle(gpointer user_data);
-static void handle_event(WorkspaceModule* mod, const char* event);
-static void refresh_window_counts(WorkspaceModule* mod);
-static void refresh_workspace_monitors(WorkspaceModule* mod);
-
-// Helper to run command and get string output
-static void popen_string(const char* cmd, char* output, size_t output_size) {
-    FILE* fp = popen(cmd, "r");
-    if (!fp) {
-        output[0] = '\0';
-        return;
-    }
-    if (fgets(output, output_size, fp) == NULL) {
-        output[0] = '\0';
-    }
-    // Remove trailing newline
-    size_t len = strlen(output);
-    if (len > 0 && output[len-1] == '\n') {
-        output[len-1] = '\0';
-    }
-    pclose(fp);
-}
-
-// Helper to run command and get integer output
-static int popen_int(const char* cmd) {
-    FILE* fp = popen(cmd, "r");
-    if (!fp) return 0;
-
-    int result = 0;
-    if (fscanf(fp, "%d", &result) != 1) {
-        result = 0;
-    }
-    pclose(fp);
-    return result;
-}
 
 // Load tertiary color from matugen CSS
 static void load_tertiary_color(WorkspaceModule* mod) {
@@ -117,463 +158,474 @@ static void load_tertiary_color(WorkspaceModule* mod) {
 // Detect which monitor this waybar instance is on (called from idle to ensure positioning is complete)
 static gboolean detect_monitor_idle(gpointer user_data) {
     WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    mod->detect_source = 0;
 
     // If monitor was set from config, use that
-    if (mod->monitor_name[0] != '\0') {
-        fprintf(stderr, "workspace_buttons: Using configured monitor: %s\n", mod->monitor_name);
-        fetch_initial_state(mod);
-        update_button_states(mod);
-        // Start IPC monitoring thread now that monitor is known
-        pthread_create(&mod->ipc_thread, NULL, ipc_monitor_thread, mod);
-        return G_SOURCE_REMOVE;
-    }
-
-    GtkWidget* widget = GTK_WIDGET(mod->container);
-    GtkWidget* toplevel = gtk_widget_get_toplevel(widget);
+    if (mod->ipc.state.monitor_name[0] != '\0') {
+        fprintf(stderr, "workspace_buttons: Using configured monitor: %s\n", mod->ipc.state.monitor_name);
+    } else {
+        GtkWidget* widget = GTK_WIDGET(mod->container);
+        GtkWidget* toplevel = gtk_widget_get_toplevel(widget);
 
-    // Get the toplevel window's allocated width - this matches the waybar surface width
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(toplevel, &alloc);
+        // Get the toplevel window's allocated width - this matches the waybar surface width
+        GtkAllocation alloc;
+        gtk_widget_get_allocation(toplevel, &alloc);
 
-    // Match by width - query Hyprland layers to find which monitor has a waybar with this width
-    char cmd[256];
-    snprintf(cmd, sizeof(cmd),
-             "hyprctl layers -j | jq -r 'to_entries[] | .key as $mon | .value.levels | to_entries[] | .value[] | select(.namespace == \"waybar\" and .w == %d) | $mon' 2>/dev/null | head -1",
-             alloc.width);
-    popen_string(cmd, mod->monitor_name, sizeof(mod->monitor_name));
+        // Match by width - query Hyprland layers to find which monitor has a waybar with this width
+        char cmd[256];
+        snprintf(cmd, sizeof(cmd),
+                 "hyprctl layers -j | jq -r 'to_entries[] | .key as $mon | .value.levels | to_entries[] | .value[] | select(.namespace == \"waybar\" and .w == %d) | $mon' 2>/dev/null | head -1",
+                 alloc.width);
+        popen_string(cmd, mod->ipc.state.monitor_name, sizeof(mod->ipc.state.monitor_name));
+
+        // Fallback: get focused monitor if detection failed
+        if (mod->ipc.state.monitor_name[0] == '\0') {
+            popen_string("hyprctl monitors -j | jq -r '.[] | select(.focused == true) | .name' 2>/dev/null",
+                         mod->ipc.state.monitor_name, sizeof(mod->ipc.state.monitor_name));
+        }
 
-    // Fallback: get focused monitor if detection failed
-    if (mod->monitor_name[0] == '\0') {
-        popen_string("hyprctl monitors -j | jq -r '.[] | select(.focused == true) | .name' 2>/dev/null",
-                     mod->monitor_name, sizeof(mod->monitor_name));
+        fprintf(stderr, "workspace_buttons: Detected monitor: %s\n", mod->ipc.state.monitor_name);
     }
 
-    fprintf(stderr, "workspace_buttons: Detected monitor: %s\n", mod->monitor_name);
-
     // Now update state with correct monitor filtering
-    fetch_initial_state(mod);
+    ipc_client_fetch(&mod->ipc);
     update_button_states(mod);
 
-    // Start IPC monitoring thread now that monitor is known
-    pthread_create(&mod->ipc_thread, NULL, ipc_monitor_thread, mod);
+    // Start IPC monitoring threads now that monitor is known
+    ipc_client_start(&mod->ipc);
+
+    // The bar may have been hidden again while detection was pending
+    if (gtk_widget_get_mapped(GTK_WIDGET(mod->container))) {
+        mod->lifecycle = LIFECYCLE_RUNNING;
+    } else {
+        mod->lifecycle = LIFECYCLE_SUSPENDED;
+        ipc_client_set_suspended(&mod->ipc, 1);
+    }
 
     return G_SOURCE_REMOVE;
 }
 
-// Callback to schedule monitor detection after widget is mapped (positioned)
+// Map signal: first map schedules monitor detection, later maps resume.
+// Waybar's SIGUSR1 toggle unmaps/maps the bar, so this must be idempotent.
 static void on_widget_map(GtkWidget* widget, gpointer user_data) {
-    // Use idle callback to ensure window positioning is complete
-    g_idle_add(detect_monitor_idle, user_data);
-}
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
 
-// Parse workspace state from hyprctl using jq
-static void fetch_initial_state(WorkspaceModule* mod) {
-    char cmd[256];
+    switch (mod->lifecycle) {
+    case LIFECYCLE_CREATED:
+        // Use idle callback to ensure window positioning is complete
+        mod->lifecycle = LIFECYCLE_DETECTING;
+        mod->detect_source = g_idle_add(detect_monitor_idle, mod);
+        break;
+    case LIFECYCLE_SUSPENDED:
+        // Monitor and IPC thread are already set up - just resume. The IPC thread
+        // resyncs and queues the one restyle; without it nothing can have changed.
+        mod->lifecycle = LIFECYCLE_RUNNING;
+        ipc_client_set_suspended(&mod->ipc, 0);
+        break;
+    case LIFECYCLE_DETECTING:
+    case LIFECYCLE_RUNNING:
+    case LIFECYCLE_STOPPING:
+        break;
+    }
+}
 
-    // Get THIS monitor's active workspace and focus state
-    if (mod->monitor_name[0] != '\0') {
-        snprintf(cmd, sizeof(cmd),
-                 "hyprctl monitors -j | jq -r '.[] | select(.name == \"%s\") | .activeWorkspace.id' 2>/dev/null",
-                 mod->monitor_name);
-        mod->this_monitor_workspace = popen_int(cmd);
+// Unmap signal: bar hidden (SIGUSR1 toggle) or being torn down
+static void on_widget_unmap(GtkWidget* widget, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
 
-        snprintf(cmd, sizeof(cmd),
-                 "hyprctl monitors -j | jq -r '.[] | select(.name == \"%s\") | .focused' 2>/dev/null",
-                 mod->monitor_name);
-        char focused[8];
-        popen_string(cmd, focused, sizeof(focused));
-        mod->user_focused_here = (strcmp(focused, "true") == 0);
-    } else {
-        // Fallback if monitor not yet detected
-        mod->this_monitor_workspace = popen_int("hyprctl activeworkspace -j | jq -r '.id' 2>/dev/null");
-        mod->user_focused_here = 1;
+    if (mod->lifecycle == LIFECYCLE_RUNNING) {
+        mod->lifecycle = LIFECYCLE_SUSPENDED;
+        ipc_client_set_suspended(&mod->ipc, 1);
     }
+    // A hidden bar doesn't blink; the resync on map subscribes again
+    blink_timer_unsubscribe(&mod->blink);
+}
 
-    // Reset state
-    memset(mod->workspace_windows, 0, sizeof(mod->workspace_windows));
-    memset(mod->special_windows, 0, sizeof(mod->special_windows));
-    memset(mod->workspace_monitor, 0, sizeof(mod->workspace_monitor));
-
-    // Get workspace monitor assignments
-    for (int i = 1; i <= NUM_WORKSPACES; i++) {
-        snprintf(cmd, sizeof(cmd),
-                 "hyprctl workspaces -j | jq -r '.[] | select(.id == %d) | .monitor' 2>/dev/null", i);
-        popen_string(cmd, mod->workspace_monitor[i-1], sizeof(mod->workspace_monitor[i-1]));
+// Frame clock before-paint: apply everything committed since the last frame.
+// Runs ahead of the layout phase, so the restyle lands in this very frame.
+static void on_before_paint(GdkFrameClock* clock, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    if (!mod->ui_dirty) return;
+    mod->ui_dirty = 0;
+    if (mod->lifecycle == LIFECYCLE_RUNNING) {
+        update_button_states(mod);
     }
+}
 
-    // Count windows per regular workspace (1-9)
-    for (int i = 1; i <= NUM_WORKSPACES; i++) {
-        snprintf(cmd, sizeof(cmd),
-                 "hyprctl clients -j | jq '[.[] | select(.workspace.id == %d)] | length' 2>/dev/null", i);
-        mod->workspace_windows[i - 1] = popen_int(cmd);
+// Follow the toplevel's frame clock, which only exists while realized
+static void on_widget_realize(GtkWidget* widget, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    mod->frame_clock = gtk_widget_get_frame_clock(widget);
+    if (mod->frame_clock) {
+        mod->before_paint_handler = g_signal_connect(mod->frame_clock, "before-paint",
+                                                     G_CALLBACK(on_before_paint), mod);
     }
+}
 
-    // Count windows per special workspace (special:1 through special:9)
-    for (int i = 1; i <= NUM_WORKSPACES; i++) {
-        snprintf(cmd, sizeof(cmd),
-                 "hyprctl clients -j | jq '[.[] | select(.workspace.name == \"special:%d\")] | length' 2>/dev/null", i);
-        mod->special_windows[i - 1] = popen_int(cmd);
-    }
-}
-
-// Batched refresh: update all window counts with single hyprctl call
-static void refresh_window_counts(WorkspaceModule* mod) {
-    // Reset counts
-    memset(mod->workspace_windows, 0, sizeof(mod->workspace_windows));
-    memset(mod->special_windows, 0, sizeof(mod->special_windows));
-
-    // Single hyprctl call - read all client data at once
-    FILE* fp = popen("hyprctl clients -j 2>/dev/null", "r");
-    if (!fp) return;
-
-    // Read entire output
-    char buffer[32768];
-    size_t total = 0;
-    size_t bytes;
-    while ((bytes = fread(buffer + total, 1, sizeof(buffer) - total - 1, fp)) > 0) {
-        total += bytes;
-        if (total >= sizeof(buffer) - 1) break;
-    }
-    buffer[total] = '\0';
-    pclose(fp);
-
-    // Parse workspace IDs from JSON - look for "workspace":{"id":N patterns
-    // This is a simple parser that counts occurrences
-    const char* ptr = buffer;
-    while ((ptr = strstr(ptr, "\"workspace\"")) != NULL) {
-        // Look for "id": followed by a number
-        const char* id_ptr = strstr(ptr, "\"id\":");
-        const char* name_ptr = strstr(ptr, "\"name\":");
-
-        if (id_ptr && (name_ptr == NULL || id_ptr < name_ptr)) {
-            id_ptr += 5; // skip "id":
-            while (*id_ptr == ' ') id_ptr++;
-            int ws_id = atoi(id_ptr);
-
-            // Regular workspace (1-9)
-            if (ws_id >= 1 && ws_id <= NUM_WORKSPACES) {
-                mod->workspace_windows[ws_id - 1]++;
-            }
-        }
+static void on_widget_size_allocate(GtkWidget* widget, GdkRectangle* alloc, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    mod->size_allocs++;
+    if (alloc->width != mod->alloc_width || alloc->height != mod->alloc_height) {
+        mod->resizes++;
+        mod->alloc_width = alloc->width;
+        mod->alloc_height = alloc->height;
+    }
+}
 
-        // Check for special workspace by name
-        if (name_ptr) {
-            name_ptr += 7; // skip "name":
-            while (*name_ptr == ' ' || *name_ptr == '"') name_ptr++;
-            if (strncmp(name_ptr, "special:", 8) == 0) {
-                int special_id = atoi(name_ptr + 8);
-                if (special_id >= 1 && special_id <= NUM_WORKSPACES) {
-                    mod->special_windows[special_id - 1]++;
-                }
-            }
-        }
+static void on_widget_unrealize(GtkWidget* widget, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    if (mod->before_paint_handler) {
+        g_signal_handler_disconnect(mod->frame_clock, mod->before_paint_handler);
+        mod->before_paint_handler = 0;
+    }
+    mod->frame_clock = NULL;
+    // Nothing to paint while unrealized; showing the bar again resyncs
+    mod->ui_dirty = 0;
+}
 
-        ptr++;
+// Update the widgets in the next frame's before-paint phase
+static void schedule_ui_update(WorkspaceModule* mod) {
+    if (mod->frame_clock) {
+        mod->ui_dirty = 1;
+        gdk_frame_clock_request_phase(mod->frame_clock, GDK_FRAME_CLOCK_PHASE_BEFORE_PAINT);
+    } else {
+        update_button_states(mod);
     }
 }
 
-// Batched refresh: update workspace-to-monitor mapping
-static void refresh_workspace_monitors(WorkspaceModule* mod) {
-    memset(mod->workspace_monitor, 0, sizeof(mod->workspace_monitor));
+// New render state from the worker (GTK main thread). The source is disarmed
+// first so a commit landing after this schedules another dispatch; commits
+// within one frame interval collapse into a single before-paint update.
+static gboolean ui_source_dispatch(GSource* source, GSourceFunc callback, gpointer user_data) {
+    WorkspaceModule* mod = ((UiSource*)source)->mod;
+    g_source_set_ready_time(source, -1);
+    // No UI work while hidden - resuming queues a fresh update
+    if (mod->lifecycle != LIFECYCLE_RUNNING) return G_SOURCE_CONTINUE;
+
+    mod->ui_requests++;
+    schedule_ui_update(mod);
+    return G_SOURCE_CONTINUE;
+}
 
-    FILE* fp = popen("hyprctl workspaces -j 2>/dev/null", "r");
-    if (!fp) return;
+static GSourceFuncs ui_source_funcs = {
+    .dispatch = ui_source_dispatch,
+};
 
-    char buffer[8192];
-    size_t total = 0;
-    size_t bytes;
-    while ((bytes = fread(buffer + total, 1, sizeof(buffer) - total - 1, fp)) > 0) {
-        total += bytes;
-        if (total >= sizeof(buffer) - 1) break;
-    }
-    buffer[total] = '\0';
-    pclose(fp);
+// IPC commit callback (state worker): schedule a UI update without allocating
+static void queue_ui_update(void* user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    g_source_set_ready_time(mod->ui_source, 0);
+}
 
-    // Parse workspace entries - look for "id":N and "monitor":"NAME" pairs
-    const char* ptr = buffer;
-    while ((ptr = strstr(ptr, "\"id\":")) != NULL) {
-        ptr += 5;
-        int ws_id = atoi(ptr);
+// SlotPoolOps: append a new button to the container
+static void pool_create(void* user_data, int slot) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    WorkspaceButton* button = &mod->buttons[slot];
+
+    workspace_button_init(button, "", mod->tertiary_color);
+    button->keep_space = mod->config.stable_layout;
+    if (mod->config.view.app_icons) workspace_button_enable_apps(button);
+    if (mod->config.badges) workspace_button_enable_badges(button);
+    // Wheel events bubble up to the container's scroll handler
+    gtk_widget_add_events(GTK_WIDGET(button->button), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+    g_signal_connect(button->button, "clicked", G_CALLBACK(on_button_clicked), button);
+    if (mod->config.tooltip) {
+        gtk_widget_set_has_tooltip(GTK_WIDGET(button->button), TRUE);
+        g_signal_connect(button->button, "query-tooltip", G_CALLBACK(on_button_query_tooltip), mod);
+        connect_tooltip_hidden(GTK_WIDGET(button->button), mod);
+    }
+    gtk_container_add(GTK_CONTAINER(mod->container), GTK_WIDGET(button->button));
+    gtk_widget_show_all(GTK_WIDGET(button->button));
+}
 
-        // Find associated monitor
-        const char* mon_ptr = strstr(ptr, "\"monitor\":");
-        const char* next_id = strstr(ptr, "\"id\":");
+// SlotPoolOps: point an existing button at another workspace
+// (the label follows in update_button_states)
+static void pool_bind(void* user_data, int slot, int workspace) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    mod->buttons[slot].workspace = workspace;
+}
 
-        if (mon_ptr && (next_id == NULL || mon_ptr < next_id)) {
-            mon_ptr += 10;
-            while (*mon_ptr == ' ' || *mon_ptr == '"') mon_ptr++;
+// SlotPoolOps: container order follows the pool's slot order
+static void pool_move(void* user_data, int slot, int position) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    gtk_box_reorder_child(mod->container, GTK_WIDGET(mod->buttons[slot].button), position);
+}
 
-            if (ws_id >= 1 && ws_id <= NUM_WORKSPACES) {
-                char* dest = mod->workspace_monitor[ws_id - 1];
-                int i = 0;
-                while (*mon_ptr && *mon_ptr != '"' && i < 63) {
-                    dest[i++] = *mon_ptr++;
-                }
-                dest[i] = '\0';
-            }
-        }
+static const SlotPoolOps pool_ops = {
+    .create = pool_create,
+    .bind = pool_bind,
+    .move = pool_move,
+};
+
+// Icons for a slot's classes. Returns -1 when the slot already shows them;
+// otherwise fills surfaces (classes without an icon are left out) and
+// returns how many. Only classes never seen at this size reach the theme.
+static int resolve_apps(WorkspaceModule* mod, int slot, const WorkspaceButtonRender* state,
+                        cairo_surface_t** surfaces) {
+    AppSlot* shown = &mod->app_slots[slot];
+    unsigned generation = app_icon_generation();
+    int scale = gtk_widget_get_scale_factor(GTK_WIDGET(mod->container));
+
+    if (shown->valid && shown->generation == generation && shown->scale == scale &&
+        shown->count == state->app_count &&
+        memcmp(shown->apps, state->apps, (size_t)state->app_count * sizeof(AppClassId)) == 0) {
+        return -1;
+    }
+    shown->valid = 1;
+    shown->generation = generation;
+    shown->scale = scale;
+    shown->count = state->app_count;
+    memcpy(shown->apps, state->apps, sizeof(shown->apps));
+
+    int count = 0;
+    for (int i = 0; i < state->app_count; i++) {
+        cairo_surface_t* surface = app_icon_get(state->apps[i], mod->config.app_icon_size, scale);
+        if (surface) surfaces[count++] = surface;
     }
+    return count;
 }
 
-// Handle a single event from Hyprland socket (fast, no subprocess spawning)
-static void handle_event(WorkspaceModule* mod, const char* event) {
-    // Skip events until monitor is detected
-    if (mod->monitor_name[0] == '\0') {
-        return;
-    }
+// "windows-N" class for the highest count threshold reached, NULL below all
+static const char* count_class(const WorkspaceModule* mod, const WorkspaceButtonRender* state) {
+    return state->level > 0 ? mod->config.count_classes[state->level - 1] : NULL;
+}
 
-    // workspace>>N - switched to workspace N (global event, no monitor context)
-    if (strncmp(event, "workspace>>", 11) == 0) {
-        int ws = atoi(event + 11);
-        if (ws >= 1 && ws <= NUM_WORKSPACES) {
-            // Only update if this workspace is on THIS monitor
-            const char* ws_monitor = mod->workspace_monitor[ws - 1];
-            if (ws_monitor[0] != '\0' && strcmp(ws_monitor, mod->monitor_name) == 0) {
-                mod->this_monitor_workspace = ws;
+// Blink timer tick: flip "blink" on the urgent buttons / slots in place,
+// without going through the render state
+static void on_blink(int phase, void* user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+
+    if (mod->config.render_mode == RENDER_MODE_STRIP) {
+        for (int slot = 0; slot < mod->strip.slot_count; slot++) {
+            const StripSlot* s = &mod->strip.slots[slot];
+            if (s->shown) {
+                workspace_strip_set_blink(&mod->strip, slot, phase && (s->classes & WS_CLASS_URGENT));
             }
-            // Don't set user_focused_here - let focusedmon>> handle that
         }
+        workspace_strip_commit(&mod->strip);
         return;
     }
 
-    // focusedmon>>MONITOR,WORKSPACE - focus changed to different monitor
-    if (strncmp(event, "focusedmon>>", 12) == 0) {
-        char mon[64];
-        int ws;
-        // Parse "DP-4,2" format
-        const char* comma = strchr(event + 12, ',');
-        if (comma) {
-            size_t mon_len = comma - (event + 12);
-            if (mon_len < sizeof(mon)) {
-                strncpy(mon, event + 12, mon_len);
-                mon[mon_len] = '\0';
-                ws = atoi(comma + 1);
-
-                // Update focus state for this module
-                int was_focused = mod->user_focused_here;
-                mod->user_focused_here = (strcmp(mon, mod->monitor_name) == 0);
-
-                // If focus moved TO this monitor, update active workspace
-                if (mod->user_focused_here && ws >= 1 && ws <= NUM_WORKSPACES) {
-                    mod->this_monitor_workspace = ws;
-                }
-
-                // If focus state changed, need to update UI
-                if (was_focused != mod->user_focused_here) {
-                    return; // Will trigger UI update
-                }
-            }
+    for (int slot = 0; slot < mod->pool.count; slot++) {
+        WorkspaceButton* button = &mod->buttons[slot];
+        if (slot_pool_shown(&mod->pool, slot)) {
+            workspace_button_set_blink(button, phase && (button->classes & WS_CLASS_URGENT));
         }
-        return;
     }
+}
 
-    // activespecial>>special:N,MONITOR or activespecial>>,MONITOR (closed)
-    if (strncmp(event, "activespecial>>", 15) == 0) {
-        // Special workspace state changed - refresh window counts to update dots
-        refresh_window_counts(mod);
-        return;
+// Apply the last published render state to the widgets
+static void update_button_states(WorkspaceModule* mod) {
+    WorkspaceRender render;
+    ipc_client_render(&mod->ipc, &render);
+    mod->ui_passes++;
+
+    // An open tooltip follows its workspace's windows; GTK asks again
+    if (mod->tooltip_widget && gtk_widget_get_mapped(mod->tooltip_widget) &&
+        ipc_client_window_list(&mod->ipc, mod->tooltip.workspace, &mod->tooltip)) {
+        gtk_widget_trigger_tooltip_query(mod->tooltip_widget);
     }
 
-    // Window events - need to refresh counts
-    if (strncmp(event, "openwindow>>", 12) == 0 ||
-        strncmp(event, "closewindow>>", 13) == 0 ||
-        strncmp(event, "movewindow>>", 12) == 0) {
-        refresh_window_counts(mod);
-        return;
+    int shown[MAX_WORKSPACES];
+    int count = 0;
+    int active = -1;
+    for (int i = 0; i < render.span; i++) {
+        if (!render.buttons[i].shown) continue;
+        if (render.buttons[i].classes & (WS_CLASS_ACTIVE | WS_CLASS_VISIBLE)) active = count;
+        shown[count++] = i + 1;
     }
 
-    // Workspace created/destroyed - refresh monitor assignments
-    if (strncmp(event, "createworkspace>>", 17) == 0 ||
-        strncmp(event, "destroyworkspace>>", 18) == 0) {
-        refresh_workspace_monitors(mod);
-        return;
+    // With max-visible only a window of the shown workspaces is materialized.
+    // It follows the active workspace when that changes and the wheel otherwise.
+    int visible = count;
+    if (mod->config.max_visible > 0 && count > mod->config.max_visible) {
+        int active_ws = active >= 0 ? shown[active] : 0;
+        int keep = active_ws != mod->view_active ? active : -1;
+        visible = mod->config.max_visible;
+        mod->view_first = slot_window_first(mod->view_first, count, visible, keep);
+        mod->view_active = active_ws;
+    } else {
+        mod->view_first = 0;
     }
+    mod->view_count = count;
+    const int* window = shown + mod->view_first;
 
-    // Monitor workspace move - refresh assignments
-    if (strncmp(event, "moveworkspace>>", 15) == 0) {
-        refresh_workspace_monitors(mod);
-        return;
+    // The blink timer only runs while something windowed is urgent
+    int urgent = 0;
+    for (int i = 0; i < visible; i++) {
+        if (render.buttons[window[i] - 1].classes & WS_CLASS_URGENT) urgent = 1;
     }
-}
-
-// Check if a workspace should be visible based on config
-static int should_show_workspace(WorkspaceModule* mod, int ws_index) {
-    int ws_num = ws_index + 1;
-    int is_this_monitor_ws = (ws_num == mod->this_monitor_workspace);
-    int has_windows = (mod->workspace_windows[ws_index] > 0);
-    int has_special = (mod->special_windows[ws_index] > 0);
-    int on_this_monitor = (mod->all_outputs ||
-                           mod->monitor_name[0] == '\0' ||
-                           strcmp(mod->workspace_monitor[ws_index], mod->monitor_name) == 0 ||
-                           mod->workspace_monitor[ws_index][0] == '\0');
-
-    // Always show this monitor's active workspace
-    if (is_this_monitor_ws) return 1;
-
-    // Check monitor filter
-    if (!on_this_monitor) return 0;
-
-    // Check empty filter - special windows count as "not empty"
-    if (!mod->show_empty && !has_windows && !has_special) return 0;
-
-    return 1;
-}
-
-// Update CSS classes and button visibility (must be called from GTK main thread)
-static gboolean update_ui_callback(gpointer user_data) {
-    WorkspaceModule* mod = (WorkspaceModule*)user_data;
-    update_button_states(mod);
-    return G_SOURCE_REMOVE;
-}
-
-static void update_button_states(WorkspaceModule* mod) {
-    for (int i = 0; i < NUM_WORKSPACES; i++) {
-        GtkStyleContext* ctx = gtk_widget_get_style_context(GTK_WIDGET(mod->buttons[i]));
-
-        // Check visibility
-        int should_show = should_show_workspace(mod, i);
-        gtk_widget_set_visible(GTK_WIDGET(mod->buttons[i]), should_show);
-
-        if (!should_show) continue;
-
-        // Remove all our classes first
-        gtk_style_context_remove_class(ctx, "active");
-        gtk_style_context_remove_class(ctx, "visible");
-        gtk_style_context_remove_class(ctx, "empty");
-        gtk_style_context_remove_class(ctx, "has-special");
-
-        // Apply active/visible classes based on per-monitor state
-        if ((i + 1) == mod->this_monitor_workspace) {
-            if (mod->user_focused_here) {
-                // User is focused on this monitor - full active styling with underline
-                gtk_style_context_add_class(ctx, "active");
-            } else {
-                // Workspace shown on this monitor but user focused elsewhere - highlight only
-                gtk_style_context_add_class(ctx, "visible");
+    if (mod->config.urgent_blink && urgent) {
+        blink_timer_subscribe(&mod->blink);
+    } else {
+        blink_timer_unsubscribe(&mod->blink);
+    }
+    int phase = blink_timer_phase();
+
+    if (mod->config.render_mode == RENDER_MODE_STRIP) {
+        // Slots are positional: slot k draws the k-th windowed workspace
+        int slot = 0;
+        for (; slot < visible; slot++) {
+            const WorkspaceButtonRender* button = &render.buttons[window[slot] - 1];
+            LabelCache* label = &mod->labels[slot];
+            int relabel = label_format_update(&mod->config.label, label, window[slot],
+                                              button->classes, button->windows);
+            workspace_strip_set_slot(&mod->strip, slot, window[slot], 1, button->classes,
+                                     relabel ? label->text : NULL);
+            workspace_strip_set_counts(&mod->strip, slot, button->windows, button->special,
+                                       count_class(mod, button));
+            workspace_strip_set_blink(&mod->strip, slot,
+                                      phase && (button->classes & WS_CLASS_URGENT));
+            if (mod->config.view.app_icons) {
+                cairo_surface_t* surfaces[WS_APPS_MAX];
+                int count = resolve_apps(mod, slot, button, surfaces);
+                if (count >= 0) workspace_strip_set_apps(&mod->strip, slot, surfaces, count);
             }
         }
-
-        if (mod->workspace_windows[i] == 0 && mod->special_windows[i] == 0) {
-            gtk_style_context_add_class(ctx, "empty");
+        for (; slot < mod->strip.slot_count; slot++) {
+            if (mod->strip.slots[slot].shown) {
+                workspace_strip_set_slot(&mod->strip, slot, 0, 0, 0, NULL);
+            }
         }
+        workspace_strip_commit(&mod->strip);
+        return;
+    }
 
-        if (mod->special_windows[i] > 0) {
-            gtk_style_context_add_class(ctx, "has-special");
-        }
+    slot_pool_update(&mod->pool, window, visible, &pool_ops, mod);
 
-        // Show/hide dot indicator (separate overlay, doesn't affect centering)
-        if (mod->special_windows[i] > 0) {
-            gtk_widget_show(GTK_WIDGET(mod->dot_labels[i]));
+    for (int slot = 0; slot < mod->pool.count; slot++) {
+        WorkspaceButton* button = &mod->buttons[slot];
+        if (slot_pool_shown(&mod->pool, slot)) {
+            const WorkspaceButtonRender* state = &render.buttons[button->workspace - 1];
+            LabelCache* label = &mod->labels[slot];
+            if (label_format_update(&mod->config.label, label, button->workspace,
+                                    state->classes, state->windows)) {
+                workspace_button_set_label(button, label->text);
+            }
+            workspace_button_set_counts(button, state->windows, state->special,
+                                        count_class(mod, state));
+            workspace_button_set_blink(button, phase && (state->classes & WS_CLASS_URGENT));
+            if (mod->config.view.app_icons) {
+                cairo_surface_t* surfaces[WS_APPS_MAX];
+                int count = resolve_apps(mod, slot, state, surfaces);
+                if (count >= 0) workspace_button_set_apps(button, surfaces, count);
+            }
+            workspace_button_apply(button, 1, state->classes);
         } else {
-            gtk_widget_hide(GTK_WIDGET(mod->dot_labels[i]));
+            workspace_button_apply(button, 0, button->classes);
         }
     }
 }
 
-// Button click handler - switch to workspace
-static void on_button_clicked(GtkButton* button, gpointer user_data) {
-    int workspace = GPOINTER_TO_INT(user_data);
-    char cmd[64];
-    snprintf(cmd, sizeof(cmd), "hyprctl dispatch workspace %d", workspace);
-    system(cmd);
-}
-
-// Connect to Hyprland's event socket
-static int connect_hyprland_socket(void) {
-    const char* xdg_runtime = getenv("XDG_RUNTIME_DIR");
-    const char* hypr_sig = getenv("HYPRLAND_INSTANCE_SIGNATURE");
-
-    if (!xdg_runtime || !hypr_sig) {
-        fprintf(stderr, "workspace_buttons: Missing Hyprland environment variables\n");
-        return -1;
+// Wheel over the buttons: move the max-visible window one workspace per step.
+// Without a window the event is left to Waybar's own scroll actions.
+static gboolean on_widget_scroll(GtkWidget* widget, GdkEventScroll* event, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    if (mod->config.max_visible <= 0 || mod->view_count <= mod->config.max_visible) return FALSE;
+
+    int steps = 0;
+    switch (event->direction) {
+    case GDK_SCROLL_UP:
+    case GDK_SCROLL_LEFT:
+        steps = -1;
+        break;
+    case GDK_SCROLL_DOWN:
+    case GDK_SCROLL_RIGHT:
+        steps = 1;
+        break;
+    case GDK_SCROLL_SMOOTH:
+        mod->scroll_delta += event->delta_y + event->delta_x;
+        steps = (int)mod->scroll_delta;
+        mod->scroll_delta -= steps;
+        break;
     }
+    if (steps == 0) return TRUE;
 
-    char socket_path[256];
-    snprintf(socket_path, sizeof(socket_path), "%s/hypr/%s/.socket2.sock", xdg_runtime, hypr_sig);
-
-    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (fd < 0) {
-        perror("workspace_buttons: socket");
-        return -1;
+    int first = slot_window_first(mod->view_first + steps, mod->view_count,
+                                  mod->config.max_visible, -1);
+    if (first != mod->view_first) {
+        mod->view_first = first;
+        schedule_ui_update(mod);
     }
+    return TRUE;
+}
 
-    struct sockaddr_un addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sun_family = AF_UNIX;
-    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+// No window list tooltip is open (any more): title changes stop waking the UI
+static void hide_window_list(WorkspaceModule* mod) {
+    mod->tooltip_widget = NULL;
+    ipc_client_watch_tooltip(&mod->ipc, 0);
+}
 
-    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("workspace_buttons: connect");
-        close(fd);
-        return -1;
+// Tooltip listing the windows of workspace. Watching it lets title changes
+// there reach the UI; nothing else about titles does.
+static gboolean show_window_list(WorkspaceModule* mod, GtkWidget* widget, int workspace,
+                                 GtkTooltip* tooltip) {
+    if (workspace <= 0) {
+        hide_window_list(mod);
+        return FALSE;
     }
-
-    return fd;
+    mod->tooltip_widget = widget;
+    ipc_client_watch_tooltip(&mod->ipc, workspace);
+    ipc_client_window_list(&mod->ipc, workspace, &mod->tooltip);
+    if (mod->tooltip.windows == 0) {
+        // GTK hides the tooltip when the query says there is none
+        hide_window_list(mod);
+        return FALSE;
+    }
+    gtk_tooltip_set_text(tooltip, mod->tooltip.text);
+    return TRUE;
 }
 
-// IPC monitoring thread
-static void* ipc_monitor_thread(void* arg) {
-    WorkspaceModule* mod = (WorkspaceModule*)arg;
-    char buffer[2048];
-
-    mod->socket_fd = connect_hyprland_socket();
-    if (mod->socket_fd < 0) {
-        fprintf(stderr, "workspace_buttons: Failed to connect to Hyprland socket\n");
-        return NULL;
+static gboolean on_button_query_tooltip(GtkWidget* widget, gint x, gint y, gboolean keyboard,
+                                        GtkTooltip* tooltip, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    for (int slot = 0; slot < mod->pool.count; slot++) {
+        WorkspaceButton* button = &mod->buttons[slot];
+        if (GTK_WIDGET(button->button) != widget) continue;
+        return show_window_list(mod, widget, button->shown ? button->workspace : 0, tooltip);
     }
+    return FALSE;
+}
 
-    while (mod->running) {
-        ssize_t bytes = read(mod->socket_fd, buffer, sizeof(buffer) - 1);
-        if (bytes <= 0) {
-            if (mod->running) {
-                // Try to reconnect
-                close(mod->socket_fd);
-                sleep(1);
-                mod->socket_fd = connect_hyprland_socket();
-            }
-            continue;
-        }
-
-        buffer[bytes] = '\0';
-
-        // Parse individual events (newline-separated)
-        // Fast path: parse events directly without spawning processes
-        char* line = buffer;
-        char* next;
-        int needs_update = 0;
-
-        while ((next = strchr(line, '\n')) != NULL || *line) {
-            if (next) *next = '\0';
+// The strip hit-tests the slot; the tip area makes GTK ask again per slot
+static gboolean on_strip_query_tooltip(GtkWidget* widget, gint x, gint y, gboolean keyboard,
+                                       GtkTooltip* tooltip, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    GdkRectangle area;
+    int workspace = workspace_strip_workspace_at(&mod->strip, x, &area);
+    if (workspace) gtk_tooltip_set_tip_area(tooltip, &area);
+    return show_window_list(mod, widget, workspace, tooltip);
+}
 
-            // Skip empty lines
-            if (*line) {
-                // Handle event - updates state directly where possible
-                handle_event(mod, line);
-                needs_update = 1;
-            }
+// GTK hides a tooltip when the pointer leaves its widget, clicks or scrolls
+static gboolean on_tooltip_hidden(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+    WorkspaceModule* mod = (WorkspaceModule*)user_data;
+    if (mod->tooltip_widget == widget) hide_window_list(mod);
+    return FALSE;
+}
 
-            if (!next) break;
-            line = next + 1;
-        }
+static void connect_tooltip_hidden(GtkWidget* widget, WorkspaceModule* mod) {
+    g_signal_connect(widget, "leave-notify-event", G_CALLBACK(on_tooltip_hidden), mod);
+    g_signal_connect(widget, "button-press-event", G_CALLBACK(on_tooltip_hidden), mod);
+    g_signal_connect(widget, "scroll-event", G_CALLBACK(on_tooltip_hidden), mod);
+}
 
-        // Queue single UI update for all events in this batch
-        if (needs_update) {
-            g_idle_add(update_ui_callback, mod);
-        }
-    }
+static void switch_to_workspace(int workspace) {
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "hyprctl dispatch workspace %d", workspace);
+    system(cmd);
+}
 
-    close(mod->socket_fd);
-    return NULL;
+// Button click handler - switch to the workspace the button is bound to now
+static void on_button_clicked(GtkButton* button, gpointer user_data) {
+    WorkspaceButton* ws_button = (WorkspaceButton*)user_data;
+    // With stable-layout hidden buttons are only transparent
+    if (ws_button->shown) switch_to_workspace(ws_button->workspace);
 }
 
-// Parse boolean config value from JSON string
-static int parse_bool(const char* value) {
-    if (!value) return 0;
-    // JSON booleans are "true" or "false"
-    if (strcmp(value, "true") == 0) return 1;
-    if (strcmp(value, "false") == 0) return 0;
-    // Also accept "1" / "0"
-    return atoi(value) != 0;
+// Strip click handler - the strip hit-tests the slot itself
+static void on_strip_clicked(int workspace, void* user_data) {
+    switch_to_workspace(workspace);
 }
 
 void* wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry* config_entries,
@@ -582,34 +634,26 @@ void* wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry*
     WorkspaceModule* mod = calloc(1, sizeof(WorkspaceModule));
     mod->waybar_module = init_info->obj;
     mod->init_info = init_info;
-    mod->running = 1;
-    mod->this_monitor_workspace = 1;
-    mod->user_focused_here = 1;
-
-    // Default config values
-    mod->all_outputs = 0;  // Only show workspaces on this monitor
-    mod->show_empty = 0;   // Hide empty workspaces
 
     // Parse config entries
+    module_config_init(&mod->config);
     for (size_t i = 0; i < config_entries_len; i++) {
-        if (strcmp(config_entries[i].key, "all-outputs") == 0) {
-            mod->all_outputs = parse_bool(config_entries[i].value);
-        } else if (strcmp(config_entries[i].key, "show-empty") == 0) {
-            mod->show_empty = parse_bool(config_entries[i].value);
-        } else if (strcmp(config_entries[i].key, "output") == 0) {
-            // Allow manual override of output name
-            const char* val = config_entries[i].value;
-            if (val[0] == '"') val++;
-            strncpy(mod->monitor_name, val, sizeof(mod->monitor_name) - 1);
-            size_t len = strlen(mod->monitor_name);
-            if (len > 0 && mod->monitor_name[len-1] == '"') {
-                mod->monitor_name[len-1] = '\0';
-            }
-        }
+        module_config_set(&mod->config, config_entries[i].key, config_entries[i].value);
     }
+    mod->blink.func = on_blink;
+    mod->blink.user_data = mod;
+
+    fprintf(stderr, "workspace_buttons: Config - all-outputs=%d, show-empty=%d, reconcile-interval=%d, render-mode=%s, stable-layout=%d\n",
+            mod->config.view.all_outputs, mod->config.view.show_empty, mod->config.reconcile_interval,
+            mod->config.render_mode == RENDER_MODE_STRIP ? "strip" : "buttons", mod->config.stable_layout);
 
-    fprintf(stderr, "workspace_buttons: Config - all-outputs=%d, show-empty=%d\n",
-            mod->all_outputs, mod->show_empty);
+    if (ipc_client_init(&mod->ipc, &mod->config, queue_ui_update, mod) < 0) {
+        free(mod);
+        return NULL;
+    }
+    if (mod->config.output[0] != '\0') {
+        strcpy(mod->ipc.state.monitor_name, mod->config.output);
+    }
 
     // Load theme color
     load_tertiary_color(mod);
@@ -623,46 +667,48 @@ void* wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry*
 
     // Connect map signal to detect monitor (fires after widget is positioned)
     g_signal_connect(mod->container, "map", G_CALLBACK(on_widget_map), mod);
+    g_signal_connect(mod->container, "unmap", G_CALLBACK(on_widget_unmap), mod);
+    g_signal_connect(mod->container, "realize", G_CALLBACK(on_widget_realize), mod);
+    g_signal_connect(mod->container, "unrealize", G_CALLBACK(on_widget_unrealize), mod);
+    g_signal_connect(mod->container, "size-allocate", G_CALLBACK(on_widget_size_allocate), mod);
+    g_signal_connect(mod->container, "scroll-event", G_CALLBACK(on_widget_scroll), mod);
+    if (gtk_widget_get_realized(GTK_WIDGET(mod->container))) {
+        on_widget_realize(GTK_WIDGET(mod->container), mod);
+    }
 
-    // Create 9 workspace buttons
-    for (int i = 0; i < NUM_WORKSPACES; i++) {
-        char label[8];
-        snprintf(label, sizeof(label), "%d", i + 1);
-
-        // Create button with overlay structure for proper dot positioning
-        mod->buttons[i] = GTK_BUTTON(gtk_button_new());
-        GtkOverlay* overlay = GTK_OVERLAY(gtk_overlay_new());
-
-        // Main label (centered number)
-        mod->labels[i] = GTK_LABEL(gtk_label_new(label));
-        gtk_widget_set_halign(GTK_WIDGET(mod->labels[i]), GTK_ALIGN_CENTER);
-        gtk_widget_set_valign(GTK_WIDGET(mod->labels[i]), GTK_ALIGN_CENTER);
-        gtk_container_add(GTK_CONTAINER(overlay), GTK_WIDGET(mod->labels[i]));
-
-        // Dot indicator (positioned top-right, initially hidden)
-        char dot_markup[64];
-        snprintf(dot_markup, sizeof(dot_markup),
-                 "<span font_size='5000' color='%s'>●</span>", mod->tertiary_color);
-        mod->dot_labels[i] = GTK_LABEL(gtk_label_new(NULL));
-        gtk_label_set_markup(mod->dot_labels[i], dot_markup);
-        gtk_widget_set_halign(GTK_WIDGET(mod->dot_labels[i]), GTK_ALIGN_END);
-        gtk_widget_set_valign(GTK_WIDGET(mod->dot_labels[i]), GTK_ALIGN_START);
-        gtk_widget_set_no_show_all(GTK_WIDGET(mod->dot_labels[i]), TRUE);
-        gtk_overlay_add_overlay(overlay, GTK_WIDGET(mod->dot_labels[i]));
-
-        gtk_container_add(GTK_CONTAINER(mod->buttons[i]), GTK_WIDGET(overlay));
-
-        gtk_button_set_relief(mod->buttons[i], GTK_RELIEF_NONE);
-        gtk_widget_set_can_focus(GTK_WIDGET(mod->buttons[i]), FALSE);
-
-        g_signal_connect(mod->buttons[i], "clicked",
-                         G_CALLBACK(on_button_clicked), GINT_TO_POINTER(i + 1));
+    // One drawing area for every workspace, or for the max-visible window
+    int slot_count = mod->config.max_visible > 0 ? mod->config.max_visible : MAX_WORKSPACES;
+    if (mod->config.render_mode == RENDER_MODE_STRIP &&
+        workspace_strip_init(&mod->strip, slot_count, mod->tertiary_color,
+                             on_strip_clicked, mod) < 0) {
+        fprintf(stderr, "workspace_buttons: Failed to allocate the workspace strip, using buttons\n");
+        mod->config.render_mode = RENDER_MODE_BUTTONS;
+    }
 
-        gtk_container_add(GTK_CONTAINER(mod->container), GTK_WIDGET(mod->buttons[i]));
+    if (mod->config.render_mode == RENDER_MODE_STRIP) {
+        mod->strip.keep_width = mod->config.stable_layout;
+        mod->strip.app_size = mod->config.app_icon_size;
+        mod->strip.badges = mod->config.badges;
+        gtk_widget_add_events(mod->strip.area, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+        if (mod->config.tooltip) {
+            gtk_widget_set_has_tooltip(mod->strip.area, TRUE);
+            g_signal_connect(mod->strip.area, "query-tooltip", G_CALLBACK(on_strip_query_tooltip), mod);
+            connect_tooltip_hidden(mod->strip.area, mod);
+        }
+        gtk_container_add(GTK_CONTAINER(mod->container), mod->strip.area);
+    } else {
+        // Buttons are created by the first update, once the workspaces are known
+        slot_pool_init(&mod->pool);
+        mod->pool.keep_space = mod->config.stable_layout;
     }
 
     gtk_widget_show_all(GTK_WIDGET(mod->container));
 
+    // Created once and re-armed by the state worker for every commit
+    mod->ui_source = g_source_new(&ui_source_funcs, sizeof(UiSource));
+    ((UiSource*)mod->ui_source)->mod = mod;
+    g_source_attach(mod->ui_source, NULL);
+
     // Note: IPC thread starts in detect_monitor_idle() after monitor is detected
 
     fprintf(stderr, "workspace_buttons: Initialized (tertiary=%s)\n", mod->tertiary_color);
@@ -672,11 +718,33 @@ void* wbcffi_init(const wbcffi_init_info* init_info, const wbcffi_config_entry*
 void wbcffi_deinit(void* instance) {
     WorkspaceModule* mod = (WorkspaceModule*)instance;
 
-    mod->running = 0;
-    if (mod->socket_fd > 0) {
-        shutdown(mod->socket_fd, SHUT_RDWR);
+    mod->lifecycle = LIFECYCLE_STOPPING;
+    // Widgets outlive the instance; unmap fires again when Waybar destroys them
+    g_signal_handlers_disconnect_by_data(mod->container, mod);
+    for (int slot = 0; slot < mod->pool.count; slot++) {
+        g_signal_handlers_disconnect_by_data(mod->buttons[slot].button, mod);
+        // "clicked" carries the button itself
+        g_signal_handlers_disconnect_by_data(mod->buttons[slot].button, &mod->buttons[slot]);
     }
-    pthread_join(mod->ipc_thread, NULL);
+    if (mod->config.render_mode == RENDER_MODE_STRIP) {
+        g_signal_handlers_disconnect_by_data(mod->strip.area, mod);
+    }
+    on_widget_unrealize(GTK_WIDGET(mod->container), mod);
+    if (mod->detect_source) {
+        g_source_remove(mod->detect_source);
+        mod->detect_source = 0;
+    }
+
+    ipc_client_destroy(&mod->ipc);
+    if (mod->config.render_mode == RENDER_MODE_STRIP) {
+        workspace_strip_destroy(&mod->strip);
+    }
+
+    blink_timer_unsubscribe(&mod->blink);
+
+    // Drop the UI source; the worker that armed it has been joined
+    g_source_destroy(mod->ui_source);
+    g_source_unref(mod->ui_source);
 
     free(mod);
     fprintf(stderr, "workspace_buttons: Deinitialized\n");
@@ -690,10 +758,34 @@ void wbcffi_refresh(void* instance, int signal) {
     WorkspaceModule* mod = (WorkspaceModule*)instance;
     // Reload color on signal (in case theme changed)
     load_tertiary_color(mod);
-    fetch_initial_state(mod);
-    update_button_states(mod);
+
+    // Once the IPC threads run this only queues a resync on the worker
+    ipc_client_fetch(&mod->ipc);
+    if (!mod->ipc.started && mod->lifecycle == LIFECYCLE_RUNNING) {
+        update_button_states(mod);
+    }
 }
 
 void wbcffi_doaction(void* instance, const char* action_name) {
-    // Could add custom actions here
+    WorkspaceModule* mod = (WorkspaceModule*)instance;
+
+    if (strcmp(action_name, "stats") == 0) {
+        char prefix[MONITOR_NAME_MAX + 24];
+        snprintf(prefix, sizeof(prefix), "workspace_buttons: [%s]", mod->ipc.state.monitor_name);
+        ipc_client_print_stats(&mod->ipc, stderr, prefix);
+        fprintf(stderr, "%s ui_requests=%lu ui_passes=%lu size_allocs=%lu resizes=%lu", prefix,
+                mod->ui_requests, mod->ui_passes, mod->size_allocs, mod->resizes);
+        if (mod->config.render_mode == RENDER_MODE_STRIP) {
+            fprintf(stderr, " strip_draws=%lu", mod->strip.draws);
+        } else {
+            fprintf(stderr, " buttons_created=%lu buttons_rebound=%lu buttons_moved=%lu",
+                    mod->pool.created, mod->pool.rebinds, mod->pool.moves);
+        }
+        if (mod->config.view.app_icons) {
+            const AppIconStats* icons = app_icon_stats();
+            fprintf(stderr, " app_classes=%d app_icon_requests=%lu app_icon_lookups=%lu app_icon_evictions=%lu",
+                    app_class_count(), icons->requests, icons->theme_lookups, icons->evictions);
+        }
+        fprintf(stderr, "\n");
+    }
 }
@@ -0,0 +1,648 @@
+/**
+ * Workspace state engine - see workspace_state.h
+ *
+ * Everything here runs on the state worker thread (or on a test/benchmark
+ * driver) and touches only fixed-size storage inside WorkspaceState.
+ */
+
+#include "workspace_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* const ws_class_names[WS_CLASS_COUNT] = {
+    "active",
+    "visible",
+    "empty",
+    "has-special",
+    "urgent",
+    "fullscreen",
+    "has-floating",
+};
+
+void ws_state_init(WorkspaceState* st) {
+    memset(st, 0, sizeof(*st));
+    st->this_monitor_workspace = 1;
+    st->user_focused_here = 1;
+}
+
+void ws_state_set_workspace_monitor(WorkspaceState* st, int ws, const char* monitor) {
+    if (ws >= 1 && ws <= MAX_WORKSPACES) {
+        snprintf(st->workspace_monitor[ws - 1], MONITOR_NAME_MAX, "%s", monitor);
+    }
+}
+
+// Workspace id spelled by name[0, len): digits without a leading zero, or 0
+static int parse_workspace_id(const char* name, size_t len) {
+    int id = 0;
+    if (len == 0 || len > 4 || name[0] == '0') return 0;
+    for (size_t i = 0; i < len; i++) {
+        if (name[i] < '0' || name[i] > '9') return 0;
+        id = id * 10 + (name[i] - '0');
+    }
+    return id <= MAX_WORKSPACES ? id : 0;
+}
+
+WorkspaceKey ws_key_from_name(const char* name, size_t len) {
+    if (len > 8 && strncmp(name, "special:", 8) == 0) {
+        return -parse_workspace_id(name + 8, len - 8);
+    }
+    // Regular workspaces are named after their id unless renamed
+    return parse_workspace_id(name, len);
+}
+
+static void count_window(WorkspaceState* st, WorkspaceKey workspace, int delta) {
+    int* count = NULL;
+    if (workspace > 0) count = &st->workspace_windows[workspace - 1];
+    if (workspace < 0) count = &st->special_windows[-workspace - 1];
+    if (!count) return;
+
+    *count += delta;
+    if (*count < 0) *count = 0;
+}
+
+// A regular workspace's window list changed (tooltips rebuild from the serial)
+static void touch_window_list(WorkspaceState* st, WorkspaceKey workspace) {
+    if (workspace > 0) st->window_serial[workspace - 1]++;
+}
+
+static void count_flag(int* count, int delta) {
+    *count += delta;
+    if (*count < 0) *count = 0;
+}
+
+// Track a window with WINDOW_* flags arriving on (delta 1) or leaving (-1)
+// workspace. Urgency on special:N counts toward N; fullscreen and floating
+// only count on regular workspaces.
+static void count_flags(WorkspaceState* st, WorkspaceKey workspace, unsigned flags, int delta) {
+    if (workspace == 0 || flags == 0) return;
+    int index = workspace > 0 ? workspace - 1 : -workspace - 1;
+    if (flags & WINDOW_URGENT) count_flag(&st->urgent_windows[index], delta);
+    if (workspace < 0) return;
+    if (flags & WINDOW_FULLSCREEN) count_flag(&st->fullscreen_windows[index], delta);
+    if (flags & WINDOW_FLOATING) count_flag(&st->floating_windows[index], delta);
+}
+
+// Set or clear one WINDOW_* flag. Returns 1 if it changed, 0 otherwise
+// (including unknown windows).
+static int set_window_flag(WorkspaceState* st, WindowEntry* entry, unsigned flag, int on) {
+    if (!entry || ((entry->flags & flag) != 0) == (on != 0)) return 0;
+    entry->flags ^= flag;
+    count_flags(st, entry->workspace, flag, on ? 1 : -1);
+    return 1;
+}
+
+// Copy title[0, len), cut at a UTF-8 character boundary if it doesn't fit
+static void set_title(char* dest, const char* title, size_t len) {
+    if (len >= WINDOW_TITLE_MAX) {
+        len = WINDOW_TITLE_MAX - 1;
+        while (len > 0 && ((unsigned char)title[len] & 0xC0) == 0x80) len--;
+    }
+    memcpy(dest, title, len);
+    dest[len] = '\0';
+}
+
+// Window table: open addressing, linear probing, backward-shift deletion
+
+static size_t window_hash(uint64_t address) {
+    return (size_t)((address * 0x9E3779B97F4A7C15ULL) >> (64 - WINDOW_TABLE_BITS));
+}
+
+static WindowEntry* find_window(WorkspaceState* st, uint64_t address) {
+    if (address == 0) return NULL;
+    for (size_t i = window_hash(address);; i = (i + 1) & (WINDOW_TABLE_SIZE - 1)) {
+        WindowEntry* entry = &st->windows[i];
+        if (entry->address == address) return entry;
+        if (entry->address == 0) return NULL;
+    }
+}
+
+static void remove_window(WorkspaceState* st, WindowEntry* entry) {
+    size_t hole = (size_t)(entry - st->windows);
+    size_t i = hole;
+
+    touch_window_list(st, entry->workspace);
+    count_flags(st, entry->workspace, entry->flags, -1);
+    entry->address = 0;
+    st->window_count--;
+
+    // Pull later entries of the probe chain back into the hole
+    for (;;) {
+        i = (i + 1) & (WINDOW_TABLE_SIZE - 1);
+        if (st->windows[i].address == 0) return;
+
+        size_t home = window_hash(st->windows[i].address);
+        int stays = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (stays) continue;
+
+        st->windows[hole] = st->windows[i];
+        strcpy(st->window_titles[hole], st->window_titles[i]);
+        st->windows[i].address = 0;
+        hole = i;
+    }
+}
+
+void ws_state_clear_windows(WorkspaceState* st) {
+    memset(st->windows, 0, sizeof(st->windows));
+    memset(st->urgent_windows, 0, sizeof(st->urgent_windows));
+    memset(st->fullscreen_windows, 0, sizeof(st->fullscreen_windows));
+    memset(st->floating_windows, 0, sizeof(st->floating_windows));
+    st->window_count = 0;
+    st->flags_pending = 0;
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        st->window_serial[i]++;
+    }
+}
+
+int ws_state_add_window(WorkspaceState* st, uint64_t address, WorkspaceKey workspace,
+                        AppClassId app, unsigned flags, const char* title) {
+    if (address == 0) return -1;
+
+    size_t i = window_hash(address);
+    for (;; i = (i + 1) & (WINDOW_TABLE_SIZE - 1)) {
+        if (st->windows[i].address == address) {
+            touch_window_list(st, st->windows[i].workspace);
+            count_flags(st, st->windows[i].workspace, st->windows[i].flags, -1);
+            break;
+        }
+        if (st->windows[i].address == 0) {
+            if (st->window_count >= WINDOW_TABLE_SIZE * 3 / 4) return -1;
+            st->windows[i].address = address;
+            st->window_count++;
+            break;
+        }
+    }
+    st->windows[i].workspace = workspace;
+    st->windows[i].app = app;
+    st->windows[i].flags = (unsigned short)(flags & (WINDOW_FULLSCREEN | WINDOW_FLOATING));
+    count_flags(st, workspace, st->windows[i].flags, 1);
+    set_title(st->window_titles[i], title ? title : "", title ? strlen(title) : 0);
+    touch_window_list(st, workspace);
+    return 0;
+}
+
+int ws_state_set_window_flags(WorkspaceState* st, uint64_t address, unsigned flags,
+                              unsigned mask) {
+    WindowEntry* entry = find_window(st, address);
+    if (!entry) return 0;
+    unsigned changed = (entry->flags ^ flags) & mask;
+    if (!changed) return 0;
+    count_flags(st, entry->workspace, entry->flags & changed, -1);
+    entry->flags ^= changed;
+    count_flags(st, entry->workspace, entry->flags & changed, 1);
+    return 1;
+}
+
+// Parse the "ADDRESS," prefix of a window event. Returns 0 if malformed.
+static uint64_t parse_window_address(const char* data, const char** rest) {
+    uint64_t address = strtoull(data, (char**)rest, 16);
+    return *rest == data ? 0 : address;
+}
+
+// Workspace key of the comma-terminated field at p
+static WorkspaceKey parse_workspace_field(const char* p) {
+    const char* comma = strchr(p, ',');
+    return ws_key_from_name(p, comma ? (size_t)(comma - p) : strlen(p));
+}
+
+// Whether event is the switch to the workspace createworkspacev2 just filed
+// under the focused monitor: workspace>>N on that monitor, or focusedmon>>MON,N
+// (which names the monitor itself)
+static int confirms_guess(const WorkspaceState* st, const HyprEvent* event) {
+    const char* comma;
+    switch (event->type) {
+    case EVENT_WORKSPACE:
+        return atoi(event->payload) == st->guessed_workspace;
+    case EVENT_FOCUSEDMON:
+        comma = strchr(event->payload, ',');
+        return comma && atoi(comma + 1) == st->guessed_workspace;
+    default:
+        return 0;
+    }
+}
+
+int ws_state_apply_event(WorkspaceState* st, const HyprEvent* event) {
+    const char* data = event->payload;
+
+    // Skip events until monitor is detected
+    if (st->monitor_name[0] == '\0') {
+        return 0;
+    }
+
+    // A workspace created without being switched to right away may sit on
+    // another monitor (monitor rules, dispatches aimed at other outputs):
+    // one workspaces query settles it
+    if (st->guessed_workspace) {
+        if (!confirms_guess(st, event)) st->refresh_pending = 1;
+        st->guessed_workspace = 0;
+    }
+
+    switch (event->type) {
+    case EVENT_WORKSPACE: {
+        // workspace>>N - switched to workspace N (global event, no monitor context)
+        int ws = atoi(data);
+        if (ws >= 1 && ws <= MAX_WORKSPACES) {
+            // Only update if this workspace is on THIS monitor
+            const char* ws_monitor = st->workspace_monitor[ws - 1];
+            if (ws_monitor[0] != '\0' && strcmp(ws_monitor, st->monitor_name) == 0) {
+                st->this_monitor_workspace = ws;
+            }
+            // Don't set user_focused_here - let focusedmon>> handle that
+        }
+        break;
+    }
+
+    case EVENT_FOCUSEDMON: {
+        // focusedmon>>MONITOR,WORKSPACE - focus changed to different monitor
+        char mon[MONITOR_NAME_MAX];
+        // Parse "DP-4,2" format
+        const char* comma = strchr(data, ',');
+        if (!comma) break;
+        size_t mon_len = comma - data;
+        if (mon_len >= sizeof(mon)) break;
+
+        memcpy(mon, data, mon_len);
+        mon[mon_len] = '\0';
+        int ws = atoi(comma + 1);
+
+        // The focused monitor is showing WORKSPACE
+        strcpy(st->focused_monitor, mon);
+        ws_state_set_workspace_monitor(st, ws, mon);
+
+        // Update focus state for this module
+        st->user_focused_here = (strcmp(mon, st->monitor_name) == 0);
+
+        // If focus moved TO this monitor, update active workspace
+        if (st->user_focused_here && ws >= 1 && ws <= MAX_WORKSPACES) {
+            st->this_monitor_workspace = ws;
+        }
+        break;
+    }
+
+    case EVENT_ACTIVESPECIAL:
+        // activespecial>>special:N,MONITOR - toggling a special workspace
+        // doesn't change any window counts
+        break;
+
+    // Window events are resolved through the window table. Anything the table
+    // can't resolve falls back to a workspaces query.
+
+    case EVENT_OPENWINDOW: {
+        // openwindow>>ADDRESS,WORKSPACE,CLASS,TITLE
+        const char* rest;
+        uint64_t address = parse_window_address(data, &rest);
+        if (!address || *rest != ',') {
+            st->refresh_pending = 1;
+            break;
+        }
+        WorkspaceKey workspace = parse_workspace_field(rest + 1);
+        AppClassId app = 0;
+        const char* title = NULL;
+        const char* app_name = strchr(rest + 1, ',');
+        if (app_name) {
+            app_name++;
+            const char* comma = strchr(app_name, ',');
+            app = app_class_intern(app_name, comma ? (size_t)(comma - app_name) : strlen(app_name));
+            if (comma) title = comma + 1;
+        }
+        WindowEntry* existing = find_window(st, address);
+        if (existing) count_window(st, existing->workspace, -1);
+        count_window(st, workspace, 1);
+        ws_state_add_window(st, address, workspace, app, 0, title);
+        st->flags_pending = 1;
+        break;
+    }
+
+    case EVENT_CLOSEWINDOW: {
+        // closewindow>>ADDRESS
+        const char* rest;
+        WindowEntry* entry = find_window(st, parse_window_address(data, &rest));
+        if (!entry) {
+            st->refresh_pending = 1;
+            break;
+        }
+        count_window(st, entry->workspace, -1);
+        remove_window(st, entry);
+        break;
+    }
+
+    case EVENT_MOVEWINDOW: {
+        // movewindow>>ADDRESS,WORKSPACE
+        const char* rest;
+        WindowEntry* entry = find_window(st, parse_window_address(data, &rest));
+        if (!entry || *rest != ',') {
+            st->refresh_pending = 1;
+            break;
+        }
+        WorkspaceKey workspace = parse_workspace_field(rest + 1);
+        count_window(st, entry->workspace, -1);
+        count_window(st, workspace, 1);
+        touch_window_list(st, entry->workspace);
+        touch_window_list(st, workspace);
+        count_flags(st, entry->workspace, entry->flags, -1);
+        count_flags(st, workspace, entry->flags, 1);
+        entry->workspace = workspace;
+        break;
+    }
+
+    // Urgency, fullscreen and floating are resolved through the window table
+    // alone: unknown windows are ignored rather than queried (the next resync
+    // seeds them), and events that flip nothing leave the render alone
+
+    case EVENT_URGENT: {
+        // urgent>>ADDRESS - a window wants attention
+        const char* rest;
+        WindowEntry* entry = find_window(st, parse_window_address(data, &rest));
+        if (!set_window_flag(st, entry, WINDOW_URGENT, 1)) return 0;
+        break;
+    }
+
+    case EVENT_ACTIVEWINDOW: {
+        // activewindowv2>>ADDRESS - focusing a window clears its urgency
+        const char* rest;
+        st->active_window = parse_window_address(data, &rest);
+        WindowEntry* entry = find_window(st, st->active_window);
+        if (!set_window_flag(st, entry, WINDOW_URGENT, 0)) return 0;
+        break;
+    }
+
+    case EVENT_FULLSCREEN: {
+        // fullscreen>>0|1 - about the focused window
+        WindowEntry* entry = find_window(st, st->active_window);
+        int on = data[0] != '\0' && data[0] != '0';
+        if (!set_window_flag(st, entry, WINDOW_FULLSCREEN, on)) return 0;
+        break;
+    }
+
+    case EVENT_CHANGEFLOATINGMODE: {
+        // changefloatingmode>>ADDRESS,0|1
+        const char* rest;
+        WindowEntry* entry = find_window(st, parse_window_address(data, &rest));
+        if (*rest != ',') return 0;
+        if (!set_window_flag(st, entry, WINDOW_FLOATING, rest[1] == '1')) return 0;
+        break;
+    }
+
+    case EVENT_WINDOWTITLE: {
+        // windowtitlev2>>ADDRESS,TITLE - only tooltips show titles, so this
+        // marks the workspace's list stale and leaves the render alone
+        const char* rest;
+        WindowEntry* entry = find_window(st, parse_window_address(data, &rest));
+        if (!entry || *rest != ',') return 0;
+        set_title(st->window_titles[entry - st->windows], rest + 1, strlen(rest + 1));
+        touch_window_list(st, entry->workspace);
+        return 0;
+    }
+
+    // Workspace-to-monitor mapping is maintained from the v2 lifecycle events,
+    // which carry workspace ids. Their v1 twins (createworkspace>>, ...) are ignored.
+
+    case EVENT_CREATEWORKSPACE: {
+        // createworkspacev2>>ID,NAME - usually on the focused monitor, which the
+        // switch to it that follows confirms (see confirms_guess)
+        int ws = atoi(data);
+        if (ws < 1 || ws > MAX_WORKSPACES) break;
+        if (st->focused_monitor[0] != '\0') {
+            ws_state_set_workspace_monitor(st, ws, st->focused_monitor);
+        }
+        st->guessed_workspace = ws;
+        break;
+    }
+
+    case EVENT_DESTROYWORKSPACE: {
+        // destroyworkspacev2>>ID,NAME - only empty workspaces are destroyed
+        int ws = atoi(data);
+        if (ws >= 1 && ws <= MAX_WORKSPACES) {
+            st->workspace_monitor[ws - 1][0] = '\0';
+            st->workspace_windows[ws - 1] = 0;
+        }
+        break;
+    }
+
+    case EVENT_MOVEWORKSPACE: {
+        // moveworkspacev2>>ID,NAME,MONITOR - workspace moved to a different monitor
+        const char* comma = strrchr(data, ',');
+        if (comma) {
+            ws_state_set_workspace_monitor(st, atoi(data), comma + 1);
+        }
+        break;
+    }
+
+    case EVENT_MONITORREMOVED:
+        // monitorremoved>>NAME - Hyprland migrates its workspaces; reconcile with one query
+        for (int i = 0; i < MAX_WORKSPACES; i++) {
+            if (strcmp(st->workspace_monitor[i], data) == 0) {
+                st->workspace_monitor[i][0] = '\0';
+            }
+        }
+        if (strcmp(st->focused_monitor, data) == 0) {
+            st->focused_monitor[0] = '\0';
+        }
+        st->refresh_pending = 1;
+        break;
+    }
+    return 1;
+}
+
+void ws_state_apply_snapshot(WorkspaceState* st, const WorkspaceSnapshot* snap) {
+    memcpy(st->workspace_windows, snap->workspace_windows, sizeof(st->workspace_windows));
+    memcpy(st->special_windows, snap->special_windows, sizeof(st->special_windows));
+    memcpy(st->workspace_monitor, snap->workspace_monitor, sizeof(st->workspace_monitor));
+    st->guessed_workspace = 0;
+}
+
+void ws_state_snapshot(const WorkspaceState* st, WorkspaceSnapshot* snap) {
+    memset(snap, 0, sizeof(*snap));
+    memcpy(snap->workspace_windows, st->workspace_windows, sizeof(snap->workspace_windows));
+    memcpy(snap->special_windows, st->special_windows, sizeof(snap->special_windows));
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        strcpy(snap->workspace_monitor[i], st->workspace_monitor[i]);
+    }
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        snap->has_fullscreen[i] = st->fullscreen_windows[i] > 0;
+    }
+    if (st->guessed_workspace) {
+        snap->untracked[st->guessed_workspace - 1] = 1;
+    }
+}
+
+void ws_snapshot_merge_untracked(WorkspaceSnapshot* a, WorkspaceSnapshot* b) {
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        a->untracked[i] |= b->untracked[i];
+        b->untracked[i] = a->untracked[i];
+    }
+}
+
+// FNV-1a over the snapshot fields (strings hashed up to their terminator).
+// Untracked workspaces only contribute their special:N count.
+uint64_t ws_snapshot_hash(const WorkspaceSnapshot* snap) {
+    uint64_t hash = 14695981039346656037ULL;
+#define HASH_BYTES(data, len) \
+    for (size_t k = 0; k < (len); k++) { \
+        hash ^= ((const unsigned char*)(data))[k]; \
+        hash *= 1099511628211ULL; \
+    }
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        HASH_BYTES(&snap->special_windows[i], sizeof(int));
+        HASH_BYTES(&snap->untracked[i], 1);
+        if (snap->untracked[i]) continue;
+        HASH_BYTES(&snap->workspace_windows[i], sizeof(int));
+        // Include the terminator so adjacent names can't alias
+        HASH_BYTES(snap->workspace_monitor[i], strlen(snap->workspace_monitor[i]) + 1);
+    }
+#undef HASH_BYTES
+    return hash;
+}
+
+int ws_state_should_show(const WorkspaceState* st, const WorkspaceViewConfig* config, int ws_index) {
+    int ws_num = ws_index + 1;
+    int is_this_monitor_ws = (ws_num == st->this_monitor_workspace);
+    int has_windows = (st->workspace_windows[ws_index] > 0);
+    int has_special = (st->special_windows[ws_index] > 0);
+    int known_monitor = (st->workspace_monitor[ws_index][0] != '\0');
+    int on_this_monitor = (config->all_outputs ||
+                           st->monitor_name[0] == '\0' ||
+                           !known_monitor ||
+                           strcmp(st->workspace_monitor[ws_index], st->monitor_name) == 0);
+
+    // Always show this monitor's active workspace
+    if (is_this_monitor_ws) return 1;
+
+    // Beyond the persistent range only existing workspaces get a button
+    if (ws_index >= NUM_PERSISTENT_WORKSPACES && !known_monitor && !has_windows && !has_special) {
+        return 0;
+    }
+
+    // Check monitor filter
+    if (!on_this_monitor) return 0;
+
+    // Check empty filter - special windows count as "not empty"
+    if (!config->show_empty && !has_windows && !has_special) return 0;
+
+    return 1;
+}
+
+// Insert app into the button's ascending, duplicate-free class list
+static void add_app(WorkspaceButtonRender* button, AppClassId app) {
+    int i = button->app_count;
+    while (i > 0 && button->apps[i - 1] > app) i--;
+    if (i > 0 && button->apps[i - 1] == app) return;
+    if (i == WS_APPS_MAX) return;
+    int last = button->app_count < WS_APPS_MAX ? button->app_count : WS_APPS_MAX - 1;
+    memmove(&button->apps[i + 1], &button->apps[i], (size_t)(last - i) * sizeof(AppClassId));
+    button->apps[i] = app;
+    if (button->app_count < WS_APPS_MAX) button->app_count++;
+}
+
+void ws_state_render(const WorkspaceState* st, const WorkspaceViewConfig* config,
+                     WorkspaceRender* render) {
+    render->span = 0;
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        WorkspaceButtonRender* button = &render->buttons[i];
+        button->shown = ws_state_should_show(st, config, i);
+        button->classes = 0;
+        button->windows = 0;
+        button->special = 0;
+        button->level = 0;
+        button->app_count = 0;
+        if (!button->shown) continue;
+        render->span = i + 1;
+        button->windows = st->workspace_windows[i];
+        button->special = st->special_windows[i];
+        while (button->level < config->count_level_count &&
+               button->windows >= config->count_levels[button->level]) {
+            button->level++;
+        }
+
+        // Active/visible depend on where the user is focused
+        if ((i + 1) == st->this_monitor_workspace) {
+            button->classes |= st->user_focused_here ? WS_CLASS_ACTIVE : WS_CLASS_VISIBLE;
+        }
+        if (st->workspace_windows[i] == 0 && st->special_windows[i] == 0) {
+            button->classes |= WS_CLASS_EMPTY;
+        }
+        if (st->special_windows[i] > 0) {
+            button->classes |= WS_CLASS_HAS_SPECIAL;
+        }
+        if (st->urgent_windows[i] > 0) {
+            button->classes |= WS_CLASS_URGENT;
+        }
+        if (st->fullscreen_windows[i] > 0) {
+            button->classes |= WS_CLASS_FULLSCREEN;
+        }
+        if (config->has_floating && st->floating_windows[i] > 0) {
+            button->classes |= WS_CLASS_HAS_FLOATING;
+        }
+    }
+
+    // Window classes per shown workspace, straight from the window table
+    if (!config->app_icons) return;
+    for (int i = 0; i < WINDOW_TABLE_SIZE; i++) {
+        const WindowEntry* entry = &st->windows[i];
+        if (entry->address == 0 || entry->app == 0) continue;
+        if (entry->workspace < 1 || entry->workspace > render->span) continue;
+        WorkspaceButtonRender* button = &render->buttons[entry->workspace - 1];
+        if (button->shown) add_app(button, entry->app);
+    }
+}
+
+typedef struct {
+    const char* app;
+    const char* title;
+} WindowLine;
+
+static int compare_window_lines(const void* a, const void* b) {
+    const WindowLine* x = a;
+    const WindowLine* y = b;
+    int order = strcmp(x->app, y->app);
+    return order ? order : strcmp(x->title, y->title);
+}
+
+// Append s to the list text, cut at a UTF-8 character boundary when full
+static void append_list_text(char* text, size_t* len, const char* s) {
+    size_t n = strlen(s);
+    if (*len + n >= WINDOW_LIST_TEXT_MAX) {
+        n = WINDOW_LIST_TEXT_MAX - 1 - *len;
+        while (n > 0 && ((unsigned char)s[n] & 0xC0) == 0x80) n--;
+    }
+    memcpy(text + *len, s, n);
+    *len += n;
+    text[*len] = '\0';
+}
+
+int ws_state_window_list(const WorkspaceState* st, int ws, WindowListCache* cache) {
+    unsigned serial = (ws >= 1 && ws <= MAX_WORKSPACES) ? st->window_serial[ws - 1] : 0;
+    if (cache->valid && cache->workspace == ws && cache->serial == serial) return 0;
+    cache->valid = 1;
+    cache->workspace = ws;
+    cache->serial = serial;
+
+    // Sorted by class, then title, so the list doesn't follow table order
+    WindowLine lines[WINDOW_TABLE_SIZE];
+    int count = 0;
+    for (int i = 0; i < WINDOW_TABLE_SIZE; i++) {
+        if (st->windows[i].address == 0 || st->windows[i].workspace != ws) continue;
+        lines[count].app = app_class_name(st->windows[i].app);
+        lines[count].title = st->window_titles[i];
+        count++;
+    }
+    qsort(lines, (size_t)count, sizeof(lines[0]), compare_window_lines);
+
+    size_t len = 0;
+    cache->windows = count;
+    cache->text[0] = '\0';
+    for (int i = 0; i < count && i < WINDOW_LIST_LINES_MAX; i++) {
+        if (i > 0) append_list_text(cache->text, &len, "\n");
+        if (lines[i].app[0]) {
+            append_list_text(cache->text, &len, lines[i].app);
+            if (lines[i].title[0]) append_list_text(cache->text, &len, ": ");
+        }
+        append_list_text(cache->text, &len, lines[i].title);
+    }
+    if (count > WINDOW_LIST_LINES_MAX) {
+        char more[32];
+        snprintf(more, sizeof(more), "\n+%d more", count - WINDOW_LIST_LINES_MAX);
+        append_list_text(cache->text, &len, more);
+    }
+    return 1;
+}
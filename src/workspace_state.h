@@ -0,0 +1,200 @@
+/**
+ * Workspace state engine, independent of GTK.
+ *
+ * Holds what the module knows about Hyprland (active workspace, focus,
+ * per-workspace window counts and monitors, and an address-indexed window
+ * table), applies parsed socket2 events and hyprctl snapshots to it, and
+ * computes what each button should look like. The GTK layer only consumes
+ * WorkspaceRender. All storage is fixed-size, so nothing here allocates.
+ */
+
+#pragma once
+
+#include "app_class.h"
+#include "event_queue.h"
+#include <stdint.h>
+
+// Regular workspaces 1..MAX_WORKSPACES (and special:1..special:MAX_WORKSPACES)
+// are tracked. The first NUM_PERSISTENT_WORKSPACES always have a button with
+// show-empty; higher ids only get one while they exist.
+#define MAX_WORKSPACES 256
+#define NUM_PERSISTENT_WORKSPACES 9
+#define MONITOR_NAME_MAX 64
+
+// Window table capacity (power of two); kept at most 3/4 full
+#define WINDOW_TABLE_BITS 10
+#define WINDOW_TABLE_SIZE (1 << WINDOW_TABLE_BITS)
+#define WINDOW_TITLE_MAX 128     // Longer titles are cut at a character boundary
+
+// Tooltip window lists: lines per workspace, and the text they fit in
+#define WINDOW_LIST_LINES_MAX 16
+#define WINDOW_LIST_TEXT_MAX 2048
+
+// A window's workspace: 1..MAX regular, -1..-MAX special:1..special:MAX, 0 anything else
+typedef int WorkspaceKey;
+
+// WindowEntry flags
+enum {
+    WINDOW_URGENT = 1 << 0,      // urgent>> seen, not focused since
+    WINDOW_FULLSCREEN = 1 << 1,  // Any fullscreen mode, maximized included
+    WINDOW_FLOATING = 1 << 2,
+};
+
+typedef struct {
+    uint64_t address;        // 0 marks an empty slot
+    WorkspaceKey workspace;
+    AppClassId app;          // Window class, 0 if unknown
+    unsigned short flags;    // WINDOW_* bits
+} WindowEntry;
+
+typedef struct {
+    // Monitor name for this waybar instance
+    char monitor_name[MONITOR_NAME_MAX];
+
+    int this_monitor_workspace;  // Workspace displayed on THIS module's monitor
+    int user_focused_here;       // Is user focused on THIS monitor?
+    char focused_monitor[MONITOR_NAME_MAX];   // Monitor the user is focused on (any bar)
+    int workspace_windows[MAX_WORKSPACES];    // Window count per workspace
+    int special_windows[MAX_WORKSPACES];      // Window count per special:N
+    char workspace_monitor[MAX_WORKSPACES][MONITOR_NAME_MAX]; // Monitor name per workspace
+
+    // Address -> workspace, open addressing with linear probing
+    WindowEntry windows[WINDOW_TABLE_SIZE];
+    int window_count;
+    // Title per table slot, moved along with its entry. Kept apart so probing
+    // only walks the small entries.
+    char window_titles[WINDOW_TABLE_SIZE][WINDOW_TITLE_MAX];
+    // Bumped whenever the windows of workspace i + 1, or their titles, change
+    unsigned window_serial[MAX_WORKSPACES];
+    // Urgent windows per workspace N, those on special:N included
+    int urgent_windows[MAX_WORKSPACES];
+    // Fullscreen / floating windows per regular workspace
+    int fullscreen_windows[MAX_WORKSPACES];
+    int floating_windows[MAX_WORKSPACES];
+    // Focused window from activewindowv2, which fullscreen>> is about; 0 if none
+    uint64_t active_window;
+
+    // Workspace createworkspacev2 just filed under the focused monitor, 0 if
+    // none: monitor rules can place it elsewhere, so the next event must confirm
+    int guessed_workspace;
+
+    int refresh_pending;         // An event needs a workspaces query to resolve
+    int flags_pending;           // A window opened; openwindow>> doesn't say if it floats
+} WorkspaceState;
+
+// Per-workspace data from one `hyprctl workspaces -j` reply
+typedef struct {
+    int workspace_windows[MAX_WORKSPACES];
+    int special_windows[MAX_WORKSPACES];
+    char workspace_monitor[MAX_WORKSPACES][MONITOR_NAME_MAX];
+    // A window on it is fullscreen (not hashed: window flags aren't drift)
+    unsigned char has_fullscreen[MAX_WORKSPACES];
+    // Workspaces events can't follow: renamed ones (events carry the name, not
+    // the id) and one whose monitor is a createworkspacev2 guess. Hashes skip them.
+    unsigned char untracked[MAX_WORKSPACES];
+} WorkspaceSnapshot;
+
+// Window count thresholds at most (badge-thresholds)
+#define WS_COUNT_LEVELS_MAX 4
+
+// Visibility options from the module config
+typedef struct {
+    int all_outputs;  // Show workspaces from all monitors
+    int show_empty;   // Show empty workspaces
+    int app_icons;    // Collect the window classes of each shown workspace
+    int has_floating; // Mark workspaces with floating windows
+    int count_levels[WS_COUNT_LEVELS_MAX];  // Ascending window count thresholds
+    int count_level_count;
+} WorkspaceViewConfig;
+
+// CSS classes of a workspace button
+enum {
+    WS_CLASS_ACTIVE = 1 << 0,       // This monitor's workspace, user focused here
+    WS_CLASS_VISIBLE = 1 << 1,      // This monitor's workspace, user focused elsewhere
+    WS_CLASS_EMPTY = 1 << 2,        // No windows, special ones included
+    WS_CLASS_HAS_SPECIAL = 1 << 3,  // special:N has windows (dot indicator)
+    WS_CLASS_URGENT = 1 << 4,       // A window here (or on special:N) wants attention
+    WS_CLASS_FULLSCREEN = 1 << 5,   // A window here is fullscreen
+    WS_CLASS_HAS_FLOATING = 1 << 6, // A window here floats (with has_floating)
+};
+#define WS_CLASS_COUNT 7
+
+// App icons per button at most; classes beyond are left out
+#define WS_APPS_MAX 6
+
+// CSS class name of bit (1 << i), for i < WS_CLASS_COUNT
+extern const char* const ws_class_names[WS_CLASS_COUNT];
+
+typedef struct {
+    int shown;
+    unsigned classes;  // WS_CLASS_* bits, only meaningful when shown
+    int windows;       // Regular windows on the workspace, only meaningful when shown
+    int special;       // Windows on its special:N, only meaningful when shown
+    int level;         // Count thresholds the regular windows reach (0..count_level_count)
+    AppClassId apps[WS_APPS_MAX];  // With app_icons: distinct classes, ascending id
+    int app_count;
+} WorkspaceButtonRender;
+
+typedef struct {
+    WorkspaceButtonRender buttons[MAX_WORKSPACES];
+    int span;  // 1 + index of the last shown button; nothing beyond is shown
+} WorkspaceRender;
+
+// Window list of one workspace, rebuilt only when its window_serial moves
+typedef struct {
+    int valid;
+    int workspace;
+    unsigned serial;
+    int windows;                       // Windows on the workspace
+    char text[WINDOW_LIST_TEXT_MAX];   // "class: title" lines, "" without windows
+} WindowListCache;
+
+void ws_state_init(WorkspaceState* st);
+
+// Apply one parsed socket2 event. Returns 0 if it cannot have changed the
+// render (title changes only touch window_serial; urgency, fullscreen and
+// floating events may flip nothing), non-zero otherwise.
+int ws_state_apply_event(WorkspaceState* st, const HyprEvent* event);
+
+// Replace counts and monitors with a snapshot (flag counts follow the window
+// table instead), or capture counts, monitors and fullscreen state into one
+void ws_state_apply_snapshot(WorkspaceState* st, const WorkspaceSnapshot* snap);
+void ws_state_snapshot(const WorkspaceState* st, WorkspaceSnapshot* snap);
+
+// FNV-1a over a snapshot, for cheap model-vs-compositor comparison
+uint64_t ws_snapshot_hash(const WorkspaceSnapshot* snap);
+
+// Mark workspaces untracked in either snapshot as untracked in both, so their
+// hashes only cover what the model can vouch for
+void ws_snapshot_merge_untracked(WorkspaceSnapshot* a, WorkspaceSnapshot* b);
+
+// Whether button ws_index (0-based) is shown under config
+int ws_state_should_show(const WorkspaceState* st, const WorkspaceViewConfig* config, int ws_index);
+
+// Compute the visibility and classes of every button
+void ws_state_render(const WorkspaceState* st, const WorkspaceViewConfig* config,
+                     WorkspaceRender* render);
+
+// Set the monitor of a regular workspace (1..MAX_WORKSPACES), ignoring anything else
+void ws_state_set_workspace_monitor(WorkspaceState* st, int ws, const char* monitor);
+
+// Window table, seeded from `hyprctl clients -j` on (re)sync. Adding a window
+// does not touch the counts, which come from the workspaces reply. flags are
+// the window's WINDOW_FULLSCREEN / WINDOW_FLOATING state (it starts out not
+// urgent); title may be NULL.
+void ws_state_clear_windows(WorkspaceState* st);
+int ws_state_add_window(WorkspaceState* st, uint64_t address, WorkspaceKey workspace,
+                        AppClassId app, unsigned flags, const char* title);
+
+// Set the flags bits of a known window to those of flags, keeping the others
+// and the flag counts in step. Returns 1 if any changed, 0 otherwise.
+int ws_state_set_window_flags(WorkspaceState* st, uint64_t address, unsigned flags,
+                              unsigned mask);
+
+// Bring cache up to date with the windows on regular workspace ws, straight
+// from the window table. Returns 1 if the text was rebuilt, 0 if it was
+// still current.
+int ws_state_window_list(const WorkspaceState* st, int ws, WindowListCache* cache);
+
+// Workspace key for a workspace name ("3", "special:2", ...)
+WorkspaceKey ws_key_from_name(const char* name, size_t len);
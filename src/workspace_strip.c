@@ -0,0 +1,492 @@
+/**
+ * Custom-drawn workspace strip - see workspace_strip.h
+ *
+ * Slot geometry follows the GTK box model: the label is the content box,
+ * grown to the CSS min-width/min-height, then padding, border and margin.
+ * Slots sit side by side; the strip's size request is the sum of their
+ * widths and the tallest slot, and only changes when one of them does.
+ * With keep_width the width never shrinks, so hidden slots leave their space
+ * reserved at the end instead of relayouting the bar.
+ */
+
+#include "workspace_strip.h"
+#include "workspace_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOT_RADIUS 2.0
+#define DOT_INSET 4.0
+#define APP_SPACING 2
+#define BADGE_SCALE 0.7     // Badge font size relative to the label's
+#define BADGE_INSET 1.0
+
+static void slot_apply_classes(StripSlot* slot, unsigned old_classes) {
+    unsigned changed = slot->classes ^ old_classes;
+    for (int i = 0; i < WS_CLASS_COUNT; i++) {
+        unsigned bit = 1u << i;
+        if (!(changed & bit)) continue;
+        if (slot->classes & bit) {
+            gtk_style_context_add_class(slot->style, ws_class_names[i]);
+        } else {
+            gtk_style_context_remove_class(slot->style, ws_class_names[i]);
+        }
+    }
+}
+
+static GtkStateFlags slot_state(const WorkspaceStrip* strip, int index) {
+    GtkStateFlags state = GTK_STATE_FLAG_NORMAL;
+    if (index == strip->hover) state |= GTK_STATE_FLAG_PRELIGHT;
+    if (index == strip->pressed) state |= GTK_STATE_FLAG_ACTIVE;
+    return state;
+}
+
+// Style contexts hang off the area's widget path, which is only final once
+// the area is in the hierarchy; they are (re)built lazily after style-updated
+static void ensure_slot_style(WorkspaceStrip* strip, int index) {
+    StripSlot* slot = &strip->slots[index];
+    if (slot->style) return;
+
+    GtkWidgetPath* path = gtk_widget_path_copy(gtk_widget_get_path(strip->area));
+    gtk_widget_path_append_type(path, GTK_TYPE_BUTTON);
+    gtk_widget_path_iter_set_object_name(path, -1, "button");
+
+    slot->style = gtk_style_context_new();
+    gtk_style_context_set_path(slot->style, path);
+    gtk_style_context_set_parent(slot->style, gtk_widget_get_style_context(strip->area));
+    gtk_style_context_set_state(slot->style, slot_state(strip, index));
+    gtk_widget_path_unref(path);
+
+    slot_apply_classes(slot, 0);
+    if (slot->count_class) gtk_style_context_add_class(slot->style, slot->count_class);
+    if (slot->blink) gtk_style_context_add_class(slot->style, "blink");
+    slot->measure_stale = 1;
+}
+
+static void drop_slot_styles(WorkspaceStrip* strip) {
+    for (int i = 0; i < strip->slot_count; i++) {
+        StripSlot* slot = &strip->slots[i];
+        if (slot->style) {
+            g_object_unref(slot->style);
+            slot->style = NULL;
+        }
+    }
+    strip->layout_stale = 1;
+}
+
+static void set_slot_state(WorkspaceStrip* strip, int index) {
+    if (index < 0) return;
+    StripSlot* slot = &strip->slots[index];
+    if (!slot->style) return;
+    gtk_style_context_set_state(slot->style, slot_state(strip, index));
+    // :hover/:active rules may change the font or padding
+    slot->measure_stale = 1;
+    strip->layout_stale = 1;
+}
+
+// Width of a slot's app icons, including the gap after the label
+static int apps_width(const WorkspaceStrip* strip, const StripSlot* slot) {
+    return slot->app_count * (strip->app_size + APP_SPACING);
+}
+
+// Badges use the slot's font, scaled down
+static void set_badge_font(const StripSlot* slot, PangoLayout* badge) {
+    if (!slot->font) return;
+    PangoFontDescription* font = pango_font_description_copy(slot->font);
+    int size = (int)(pango_font_description_get_size(font) * BADGE_SCALE);
+    if (pango_font_description_get_size_is_absolute(font)) {
+        pango_font_description_set_absolute_size(font, size);
+    } else {
+        pango_font_description_set_size(font, size);
+    }
+    pango_layout_set_font_description(badge, font);
+    pango_font_description_free(font);
+}
+
+// Everything a slot's size depends on in its style (font owned by the caller)
+typedef struct {
+    PangoFontDescription* font;
+    int min_width, min_height;
+    GtkBorder padding, border, margin;
+} SlotBox;
+
+static void get_slot_box(const StripSlot* slot, SlotBox* box) {
+    GtkStateFlags state = gtk_style_context_get_state(slot->style);
+    box->font = NULL;
+    box->min_width = 0;
+    box->min_height = 0;
+    gtk_style_context_get(slot->style, state, GTK_STYLE_PROPERTY_FONT, &box->font,
+                          "min-width", &box->min_width, "min-height", &box->min_height, NULL);
+    gtk_style_context_get_padding(slot->style, state, &box->padding);
+    gtk_style_context_get_border(slot->style, state, &box->border);
+    gtk_style_context_get_margin(slot->style, state, &box->margin);
+}
+
+static int slot_box_equal(const SlotBox* a, const SlotBox* b) {
+    return pango_font_description_equal(a->font, b->font) &&
+           a->min_width == b->min_width && a->min_height == b->min_height &&
+           memcmp(&a->padding, &b->padding, sizeof(GtkBorder)) == 0 &&
+           memcmp(&a->border, &b->border, sizeof(GtkBorder)) == 0 &&
+           memcmp(&a->margin, &b->margin, sizeof(GtkBorder)) == 0;
+}
+
+// Font, label size and margin box of one slot; the layout's text is already current
+static void measure_slot(WorkspaceStrip* strip, StripSlot* slot) {
+    SlotBox box;
+    get_slot_box(slot, &box);
+
+    // Re-measuring text is the expensive part; skip it if the font held
+    if (!slot->font || !pango_font_description_equal(slot->font, box.font)) {
+        pango_layout_set_font_description(slot->layout, box.font);
+        pango_layout_get_pixel_size(slot->layout, &slot->label_width, &slot->label_height);
+        if (slot->font) pango_font_description_free(slot->font);
+        slot->font = box.font;
+        for (int i = 0; i < 2; i++) {
+            if (slot->badges[i]) set_badge_font(slot, slot->badges[i]);
+        }
+    } else {
+        pango_font_description_free(box.font);
+    }
+
+    int content = slot->label_width + apps_width(strip, slot);
+    if (content < box.min_width) content = box.min_width;
+    slot->width = content + box.padding.left + box.padding.right + box.border.left +
+                  box.border.right + box.margin.left + box.margin.right;
+
+    content = slot->label_height > box.min_height ? slot->label_height : box.min_height;
+    if (slot->app_count > 0 && strip->app_size > content) content = strip->app_size;
+    slot->height = content + box.padding.top + box.padding.bottom + box.border.top +
+                   box.border.bottom + box.margin.top + box.margin.bottom;
+    slot->measure_stale = 0;
+}
+
+static void layout_slots(WorkspaceStrip* strip) {
+    int x = 0;
+    int height = 0;
+
+    for (int i = 0; i < strip->slot_count; i++) {
+        StripSlot* slot = &strip->slots[i];
+        if (!slot->shown) continue;
+        if (!slot->layout) slot->layout = gtk_widget_create_pango_layout(strip->area, slot->label);
+        ensure_slot_style(strip, i);
+        if (slot->measure_stale) measure_slot(strip, slot);
+
+        slot->x = x;
+        x += slot->width;
+        if (slot->height > height) height = slot->height;
+    }
+    strip->layout_stale = 0;
+    if (strip->keep_width && x < strip->width) x = strip->width;
+
+    // A new size request relayouts the bar; only issue one when it changed
+    if (x != strip->width || height != strip->height) {
+        strip->width = x;
+        strip->height = height;
+        gtk_widget_set_size_request(strip->area, x, height);
+    }
+}
+
+static int hit_test(const WorkspaceStrip* strip, double x) {
+    for (int i = 0; i < strip->slot_count; i++) {
+        const StripSlot* slot = &strip->slots[i];
+        if (slot->shown && x >= slot->x && x < slot->x + slot->width) return i;
+    }
+    return -1;
+}
+
+static void paint_slot(WorkspaceStrip* strip, cairo_t* cr, const StripSlot* slot, int height) {
+    GtkStateFlags state = gtk_style_context_get_state(slot->style);
+    GtkBorder margin;
+    gtk_style_context_get_margin(slot->style, state, &margin);
+
+    double x = slot->x + margin.left;
+    double y = margin.top;
+    double w = slot->width - margin.left - margin.right;
+    double h = height - margin.top - margin.bottom;
+    if (w <= 0 || h <= 0) return;
+
+    gtk_render_background(slot->style, cr, x, y, w, h);
+    gtk_render_frame(slot->style, cr, x, y, w, h);
+    // Label and icons are centred together
+    double content_x = x + (w - slot->label_width - apps_width(strip, slot)) / 2;
+    gtk_render_layout(slot->style, cr, content_x, y + (h - slot->label_height) / 2, slot->layout);
+    for (int i = 0; i < slot->app_count; i++) {
+        double icon_x = content_x + slot->label_width + APP_SPACING +
+                        i * (strip->app_size + APP_SPACING);
+        cairo_set_source_surface(cr, slot->apps[i], icon_x, y + (h - strip->app_size) / 2);
+        cairo_paint(cr);
+    }
+
+    if (slot->classes & WS_CLASS_HAS_SPECIAL) {
+        gdk_cairo_set_source_rgba(cr, &strip->dot_color);
+        cairo_arc(cr, x + w - DOT_INSET, y + DOT_INSET, DOT_RADIUS, 0, 2 * G_PI);
+        cairo_fill(cr);
+    }
+
+    // Badges: regular count bottom-right, special count bottom-left
+    for (int i = 0; strip->badges && i < 2; i++) {
+        if (slot->badge_counts[i] <= 0 || !slot->badges[i]) continue;
+        int badge_width, badge_height;
+        pango_layout_get_pixel_size(slot->badges[i], &badge_width, &badge_height);
+        double badge_x = i == 0 ? x + w - badge_width - BADGE_INSET : x + BADGE_INSET;
+        gtk_render_layout(slot->style, cr, badge_x, y + h - badge_height, slot->badges[i]);
+    }
+}
+
+static gboolean on_strip_draw(GtkWidget* widget, cairo_t* cr, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    int height = gtk_widget_get_allocated_height(widget);
+    double clip_x1, clip_y1, clip_x2, clip_y2;
+
+    strip->draws++;
+
+    // Only slots intersecting the damaged area
+    cairo_clip_extents(cr, &clip_x1, &clip_y1, &clip_x2, &clip_y2);
+    for (int i = 0; i < strip->slot_count; i++) {
+        const StripSlot* slot = &strip->slots[i];
+        if (!slot->shown || !slot->style) continue;
+        if (slot->x + slot->width <= clip_x1 || slot->x >= clip_x2) continue;
+        paint_slot(strip, cr, slot, height);
+    }
+    return FALSE;
+}
+
+// Theme or hierarchy changed: the sub-node contexts must be rebuilt
+static void on_strip_style_updated(GtkWidget* widget, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    drop_slot_styles(strip);
+    // Reserved width is in the old style's metrics
+    if (strip->keep_width) strip->width = 0;
+    workspace_strip_commit(strip);
+}
+
+static void set_hover(WorkspaceStrip* strip, int index) {
+    if (index == strip->hover) return;
+    int old = strip->hover;
+    strip->hover = index;
+    set_slot_state(strip, old);
+    set_slot_state(strip, index);
+    workspace_strip_commit(strip);
+}
+
+static gboolean on_strip_motion(GtkWidget* widget, GdkEventMotion* event, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    set_hover(strip, hit_test(strip, event->x));
+    return FALSE;
+}
+
+static gboolean on_strip_leave(GtkWidget* widget, GdkEventCrossing* event, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    set_hover(strip, -1);
+    return FALSE;
+}
+
+static gboolean on_strip_press(GtkWidget* widget, GdkEventButton* event, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    if (event->button != GDK_BUTTON_PRIMARY || event->type != GDK_BUTTON_PRESS) return FALSE;
+
+    strip->pressed = hit_test(strip, event->x);
+    set_slot_state(strip, strip->pressed);
+    workspace_strip_commit(strip);
+    return strip->pressed >= 0;
+}
+
+// Like GtkButton::clicked: release over the slot the press started on
+static gboolean on_strip_release(GtkWidget* widget, GdkEventButton* event, gpointer user_data) {
+    WorkspaceStrip* strip = user_data;
+    if (event->button != GDK_BUTTON_PRIMARY || strip->pressed < 0) return FALSE;
+
+    int pressed = strip->pressed;
+    strip->pressed = -1;
+    set_slot_state(strip, pressed);
+    workspace_strip_commit(strip);
+
+    if (hit_test(strip, event->x) == pressed && strip->slots[pressed].shown && strip->on_click) {
+        strip->on_click(strip->slots[pressed].workspace, strip->user_data);
+    }
+    return TRUE;
+}
+
+int workspace_strip_init(WorkspaceStrip* strip, int slot_count, const char* dot_color,
+                         StripClickFunc on_click, void* user_data) {
+    memset(strip, 0, sizeof(*strip));
+    strip->slots = calloc((size_t)slot_count, sizeof(StripSlot));
+    if (!strip->slots) return -1;
+    strip->slot_count = slot_count;
+    strip->hover = -1;
+    strip->pressed = -1;
+    strip->on_click = on_click;
+    strip->user_data = user_data;
+    if (!gdk_rgba_parse(&strip->dot_color, dot_color)) {
+        gdk_rgba_parse(&strip->dot_color, "#adc8f8");
+    }
+
+    strip->area = gtk_drawing_area_new();
+    gtk_widget_add_events(strip->area, GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK |
+                                       GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+    g_signal_connect(strip->area, "draw", G_CALLBACK(on_strip_draw), strip);
+    g_signal_connect(strip->area, "style-updated", G_CALLBACK(on_strip_style_updated), strip);
+    g_signal_connect(strip->area, "motion-notify-event", G_CALLBACK(on_strip_motion), strip);
+    g_signal_connect(strip->area, "leave-notify-event", G_CALLBACK(on_strip_leave), strip);
+    g_signal_connect(strip->area, "button-press-event", G_CALLBACK(on_strip_press), strip);
+    g_signal_connect(strip->area, "button-release-event", G_CALLBACK(on_strip_release), strip);
+
+    strip->layout_stale = 1;
+    return 0;
+}
+
+void workspace_strip_destroy(WorkspaceStrip* strip) {
+    g_signal_handlers_disconnect_by_data(strip->area, strip);
+    drop_slot_styles(strip);
+    for (int i = 0; i < strip->slot_count; i++) {
+        StripSlot* slot = &strip->slots[i];
+        if (slot->layout) g_object_unref(slot->layout);
+        for (int j = 0; j < 2; j++) {
+            if (slot->badges[j]) g_object_unref(slot->badges[j]);
+        }
+        if (slot->font) pango_font_description_free(slot->font);
+        for (int j = 0; j < slot->app_count; j++) {
+            cairo_surface_destroy(slot->apps[j]);
+        }
+    }
+    free(strip->slots);
+    strip->slots = NULL;
+    strip->slot_count = 0;
+}
+
+void workspace_strip_set_slot(WorkspaceStrip* strip, int index, int workspace, int shown,
+                              unsigned classes, const char* label) {
+    StripSlot* slot = &strip->slots[index];
+
+    slot->workspace = workspace;
+    if (label && (!slot->layout || strcmp(label, slot->label) != 0)) {
+        snprintf(slot->label, sizeof(slot->label), "%s", label);
+        if (slot->layout) {
+            pango_layout_set_text(slot->layout, slot->label, -1);
+        } else {
+            slot->layout = gtk_widget_create_pango_layout(strip->area, slot->label);
+        }
+        // Force the text to be measured even if the font is unchanged
+        if (slot->font) {
+            pango_font_description_free(slot->font);
+            slot->font = NULL;
+        }
+        slot->measure_stale = 1;
+        strip->layout_stale = 1;
+    }
+    if (shown != slot->shown) {
+        slot->shown = shown;
+        strip->layout_stale = 1;
+    }
+    if (classes != slot->classes) {
+        unsigned old_classes = slot->classes;
+        slot->classes = classes;
+        if (slot->style) slot_apply_classes(slot, old_classes);
+        // Class rules may change the font or box as well as the colours
+        slot->measure_stale = 1;
+        strip->layout_stale = 1;
+    }
+}
+
+void workspace_strip_set_apps(WorkspaceStrip* strip, int index, cairo_surface_t* const* surfaces,
+                              int count) {
+    StripSlot* slot = &strip->slots[index];
+    int same = (count == slot->app_count);
+    for (int i = 0; same && i < count; i++) {
+        same = (slot->apps[i] == surfaces[i]);
+    }
+    if (same) return;
+
+    cairo_surface_t* old[WS_APPS_MAX];
+    int old_count = slot->app_count;
+    memcpy(old, slot->apps, sizeof(old));
+    for (int i = 0; i < count; i++) {
+        slot->apps[i] = cairo_surface_reference(surfaces[i]);
+    }
+    for (int i = 0; i < old_count; i++) {
+        cairo_surface_destroy(old[i]);
+    }
+    slot->app_count = count;
+
+    // Same number of icons: only a repaint
+    if (count != old_count) slot->measure_stale = 1;
+    strip->layout_stale = 1;
+}
+
+void workspace_strip_set_counts(WorkspaceStrip* strip, int index, int windows, int special,
+                                const char* count_class) {
+    StripSlot* slot = &strip->slots[index];
+
+    if (count_class != slot->count_class) {
+        if (slot->style) {
+            if (slot->count_class) gtk_style_context_remove_class(slot->style, slot->count_class);
+            if (count_class) gtk_style_context_add_class(slot->style, count_class);
+        }
+        slot->count_class = count_class;
+        // Threshold rules may change the box like any other class
+        slot->measure_stale = 1;
+        strip->layout_stale = 1;
+    }
+
+    if (!strip->badges) return;
+    int counts[2] = { windows, special };
+    for (int i = 0; i < 2; i++) {
+        if (counts[i] == slot->badge_counts[i]) continue;
+        slot->badge_counts[i] = counts[i];
+        strip->redraw = 1;
+        if (counts[i] <= 0) continue;
+
+        char text[16];
+        snprintf(text, sizeof(text), "%d", counts[i]);
+        if (slot->badges[i]) {
+            pango_layout_set_text(slot->badges[i], text, -1);
+        } else {
+            slot->badges[i] = gtk_widget_create_pango_layout(strip->area, text);
+            set_badge_font(slot, slot->badges[i]);
+        }
+    }
+}
+
+void workspace_strip_set_blink(WorkspaceStrip* strip, int index, int blink) {
+    StripSlot* slot = &strip->slots[index];
+    if (blink == slot->blink) return;
+    slot->blink = blink;
+    if (!slot->style) return;
+
+    // Blink rules normally only change colours: then this is a repaint, and
+    // only a box that actually moved costs a re-measure and relayout
+    SlotBox before, after;
+    get_slot_box(slot, &before);
+    if (blink) {
+        gtk_style_context_add_class(slot->style, "blink");
+    } else {
+        gtk_style_context_remove_class(slot->style, "blink");
+    }
+    get_slot_box(slot, &after);
+    if (slot_box_equal(&before, &after)) {
+        strip->redraw = 1;
+    } else {
+        slot->measure_stale = 1;
+        strip->layout_stale = 1;
+    }
+    pango_font_description_free(before.font);
+    pango_font_description_free(after.font);
+}
+
+void workspace_strip_commit(WorkspaceStrip* strip) {
+    if (strip->layout_stale) {
+        layout_slots(strip);
+    } else if (!strip->redraw) {
+        return;
+    }
+    strip->redraw = 0;
+    gtk_widget_queue_draw(strip->area);
+}
+
+int workspace_strip_workspace_at(const WorkspaceStrip* strip, double x, GdkRectangle* area) {
+    int index = hit_test(strip, x);
+    if (index < 0) return 0;
+    const StripSlot* slot = &strip->slots[index];
+    *area = (GdkRectangle){ slot->x, 0, slot->width, gtk_widget_get_allocated_height(strip->area) };
+    return slot->workspace;
+}
@@ -0,0 +1,97 @@
+/**
+ * Custom-drawn workspace strip (render-mode "strip").
+ *
+ * One GtkDrawingArea paints every workspace button with cairo/Pango instead
+ * of a GtkButton/GtkOverlay/GtkLabel subtree per workspace, and does its own
+ * hit-testing for hover and clicks.
+ *
+ * Each slot has its own GtkStyleContext for a "button" sub-node below the
+ * area's CSS node, carrying the slot's WS_CLASS_* classes and hover/pressed
+ * state, so themes written for the widget tree (`#workspaces button.active`)
+ * apply unchanged. Pango layouts are cached per slot: the text is only set
+ * when the label changes and re-measured only when the text or the resolved
+ * font does. Window count badges are painted over the slot's bottom
+ * corners, so a count change is a repaint, never a relayout.
+ */
+
+#pragma once
+
+#include "label_format.h"
+#include "workspace_state.h"
+#include <gtk/gtk.h>
+
+// Left click on a slot bound to workspace
+typedef void (*StripClickFunc)(int workspace, void* user_data);
+
+typedef struct {
+    int workspace;              // Workspace id the slot is bound to, 0 if none
+    int shown;
+    unsigned classes;           // WS_CLASS_* bits
+    char label[LABEL_TEXT_MAX];
+
+    GtkStyleContext* style;     // "button" sub-node, NULL until the area is styled
+    PangoLayout* layout;        // Cached label layout, created on first label
+    PangoFontDescription* font; // Font the layout was last measured with
+    int measure_stale;          // Label, classes or state changed since measuring
+    int label_width, label_height;
+    int x, width, height;       // Margin box, in strip coordinates
+    cairo_surface_t* apps[WS_APPS_MAX]; // App icons after the label (referenced)
+    int app_count;
+    const char* count_class;    // "windows-N" class, NULL if none
+    int badge_counts[2];        // Regular / special window count, 0 when hidden
+    PangoLayout* badges[2];     // Badge text, created on first use
+    int blink;                  // "blink" class (urgent-blink on phase)
+} StripSlot;
+
+typedef struct {
+    GtkWidget* area;            // The drawing area, owned by its GTK parent
+    StripSlot* slots;
+    int slot_count;
+    int hover;                  // Slot under the pointer, -1 if none
+    int pressed;                // Slot the primary button went down on, -1 if none
+    GdkRGBA dot_color;          // Special-workspace indicator
+    StripClickFunc on_click;
+    void* user_data;
+
+    int layout_stale;           // Some slot needs measuring or repositioning
+    int width, height;          // Current size request
+    int keep_width;             // Never shrink the request until the style changes
+    int app_size;               // App icon size in logical pixels
+    int badges;                 // Paint window count badges
+    int redraw;                 // Something changed that needs no relayout
+    unsigned long draws;        // Draw handler runs
+} WorkspaceStrip;
+
+// Create the area and slot_count unbound slots. Slots are cheap until they get
+// a label. Returns -1 on allocation failure.
+int workspace_strip_init(WorkspaceStrip* strip, int slot_count, const char* dot_color,
+                         StripClickFunc on_click, void* user_data);
+
+// Release slots, styles and layouts and disconnect from the area (which its
+// parent destroys)
+void workspace_strip_destroy(WorkspaceStrip* strip);
+
+// Rebind slot index; label NULL keeps the current label. Cheap when nothing
+// changes, so callers may set every slot on every commit.
+void workspace_strip_set_slot(WorkspaceStrip* strip, int index, int workspace, int shown,
+                              unsigned classes, const char* label);
+
+// Show surfaces[0, count) as the slot's app icons (app_size square each)
+void workspace_strip_set_apps(WorkspaceStrip* strip, int index, cairo_surface_t* const* surfaces,
+                              int count);
+
+// Window counts for the slot's badges (ignored unless badges is set) and its
+// count_class (NULL for none; compared by pointer, must outlive the strip).
+// Counts alone only repaint.
+void workspace_strip_set_counts(WorkspaceStrip* strip, int index, int windows, int special,
+                                const char* count_class);
+
+// Add or remove the slot's "blink" class
+void workspace_strip_set_blink(WorkspaceStrip* strip, int index, int blink);
+
+// Measure what changed, update the size request if needed and queue one redraw
+void workspace_strip_commit(WorkspaceStrip* strip);
+
+// Workspace of the shown slot at x (0 if none), and the slot's area for
+// gtk_tooltip_set_tip_area()
+int workspace_strip_workspace_at(const WorkspaceStrip* strip, double x, GdkRectangle* area);
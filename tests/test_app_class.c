@@ -0,0 +1,157 @@
+/**
+ * Window classes: the shared class table, and the per-workspace class lists
+ * the render state builds from the window table for app icons.
+ */
+
+#include "app_class.h"
+#include "hyprctl_parse.h"
+#include "test_util.h"
+#include <pthread.h>
+
+#define INTERN_THREADS 4
+
+static void test_intern(void) {
+    AppClassId firefox = app_class_intern("firefox", 7);
+    CHECK(firefox != 0);
+    CHECK_INT("same name", app_class_intern("firefox,extra", 7), firefox);
+    CHECK_STR("name", app_class_name(firefox), "firefox");
+    CHECK(app_class_intern("Firefox", 7) != firefox);
+    CHECK_INT("empty name", app_class_intern("", 0), 0);
+    CHECK_STR("unknown name", app_class_name(0), "");
+
+    char long_name[APP_CLASS_NAME_MAX * 2];
+    memset(long_name, 'x', sizeof(long_name));
+    AppClassId truncated = app_class_intern(long_name, sizeof(long_name));
+    CHECK_INT("truncated length", strlen(app_class_name(truncated)), APP_CLASS_NAME_MAX - 1);
+    CHECK_INT("truncated again", app_class_intern(long_name, APP_CLASS_NAME_MAX + 3), truncated);
+}
+
+static void* intern_worker(void* arg) {
+    AppClassId* ids = arg;
+    char name[32];
+    for (int i = 0; i < 64; i++) {
+        int len = snprintf(name, sizeof(name), "shared-%d", i);
+        ids[i] = app_class_intern(name, (size_t)len);
+    }
+    return NULL;
+}
+
+// Bars intern from their own worker threads: everyone must get the same ids
+static void test_threads(void) {
+    static AppClassId ids[INTERN_THREADS][64];
+    pthread_t threads[INTERN_THREADS];
+    for (int t = 0; t < INTERN_THREADS; t++) {
+        pthread_create(&threads[t], NULL, intern_worker, ids[t]);
+    }
+    for (int t = 0; t < INTERN_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (int i = 0; i < 64; i++) {
+        CHECK(ids[0][i] != 0);
+        for (int t = 1; t < INTERN_THREADS; t++) {
+            CHECK_INT("same id across threads", ids[t][i], ids[0][i]);
+        }
+    }
+}
+
+static void apply(WorkspaceState* st, const char* text) {
+    replay_events(st, text, strlen(text), 0);
+}
+
+// Classes follow windows through open/move/close; specials don't count
+static void test_render_apps(void) {
+    static WorkspaceState st;
+    WorkspaceViewConfig view = { .all_outputs = 1, .show_empty = 1, .app_icons = 1 };
+    WorkspaceRender render;
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    apply(&st, "openwindow>>a1,1,kitty,shell\n"
+               "openwindow>>a2,1,firefox,Some, title\n"
+               "openwindow>>a3,1,kitty,another shell\n"
+               "openwindow>>a4,special:1,slack,chat\n"
+               "openwindow>>a5,2,firefox,docs\n");
+    ws_state_render(&st, &view, &render);
+
+    AppClassId kitty = app_class_intern("kitty", 5);
+    AppClassId firefox = app_class_intern("firefox", 7);
+    AppClassId lo = kitty < firefox ? kitty : firefox;
+    AppClassId hi = kitty < firefox ? firefox : kitty;
+    CHECK_INT("ws1 apps", render.buttons[0].app_count, 2);
+    CHECK_INT("ws1 first", render.buttons[0].apps[0], lo);
+    CHECK_INT("ws1 second", render.buttons[0].apps[1], hi);
+    CHECK_INT("ws2 apps", render.buttons[1].app_count, 1);
+    CHECK_INT("ws2 app", render.buttons[1].apps[0], firefox);
+
+    apply(&st, "movewindow>>a2,2\nclosewindow>>a1\nclosewindow>>a3\n");
+    ws_state_render(&st, &view, &render);
+    CHECK_INT("ws1 apps after", render.buttons[0].app_count, 0);
+    CHECK_INT("ws2 apps after", render.buttons[1].app_count, 1);
+
+    // Without app icons nothing is collected
+    view.app_icons = 0;
+    ws_state_render(&st, &view, &render);
+    CHECK_INT("disabled", render.buttons[1].app_count, 0);
+}
+
+// More distinct classes than a button holds: the lowest ids are kept
+static void test_render_apps_limit(void) {
+    static WorkspaceState st;
+    WorkspaceViewConfig view = { .all_outputs = 1, .show_empty = 1, .app_icons = 1 };
+    WorkspaceRender render;
+    char line[64];
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    for (int i = 0; i < WS_APPS_MAX + 3; i++) {
+        snprintf(line, sizeof(line), "openwindow>>b%d,3,limit-%d,title\n", i, i);
+        apply(&st, line);
+    }
+    ws_state_render(&st, &view, &render);
+    CHECK_INT("capped", render.buttons[2].app_count, WS_APPS_MAX);
+    for (int i = 1; i < render.buttons[2].app_count; i++) {
+        CHECK(render.buttons[2].apps[i - 1] < render.buttons[2].apps[i]);
+    }
+    CHECK_INT("lowest kept", render.buttons[2].apps[0], app_class_intern("limit-0", 7));
+}
+
+static void test_clients_class(void) {
+    static WorkspaceState st;
+    ws_state_init(&st);
+    const char* reply =
+        "[{\"address\": \"0xc1\", \"class\": \"org.gnome.Nautilus\","
+        " \"workspace\": {\"id\": 4, \"name\": \"4\"}},"
+        " {\"address\": \"0xc2\", \"workspace\": {\"id\": 4, \"name\": \"4\"}}]";
+    CHECK_INT("parse", hyprctl_parse_clients(reply, &st), 0);
+
+    WorkspaceViewConfig view = { .all_outputs = 1, .show_empty = 1, .app_icons = 1 };
+    WorkspaceRender render;
+    ws_state_render(&st, &view, &render);
+    CHECK_INT("ws4 apps", render.buttons[3].app_count, 1);
+    CHECK_STR("ws4 class", app_class_name(render.buttons[3].apps[0]), "org.gnome.Nautilus");
+}
+
+// Runs last: fills the process-wide table
+static void test_full(void) {
+    char name[32];
+    AppClassId last = 1;
+    for (int i = 0; i < APP_CLASS_MAX + 10; i++) {
+        int len = snprintf(name, sizeof(name), "fill-%d", i);
+        AppClassId id = app_class_intern(name, (size_t)len);
+        if (id) last = id;
+    }
+    CHECK_INT("count", app_class_count(), APP_CLASS_MAX);
+    CHECK_INT("last id", last, APP_CLASS_MAX);
+    CHECK_INT("full", app_class_intern("one-more", 8), 0);
+    CHECK(app_class_intern("firefox", 7) != 0);
+}
+
+int main(void) {
+    test_intern();
+    test_threads();
+    test_render_apps();
+    test_render_apps_limit();
+    test_clients_class();
+    test_full();
+    return test_result("app_class");
+}
@@ -0,0 +1,219 @@
+/**
+ * Config entry parsing (module_config_set), with values encoded the way
+ * Waybar's CFFI ABI v2 passes them: as JSON.
+ */
+
+#include "module_config.h"
+#include "test_util.h"
+
+typedef struct {
+    const char* key;
+    const char* value;
+    int known;                // Expected module_config_set() success
+    int all_outputs;
+    int show_empty;
+    int reconcile_interval;
+    const char* output;
+    RenderMode render_mode;
+    int stable_layout;
+    int max_visible;
+} ConfigCase;
+
+// Defaults: all-outputs=0, show-empty=0, reconcile-interval=60, output="",
+// render-mode=buttons, stable-layout=0, max-visible=0
+static const ConfigCase cases[] = {
+    { "all-outputs", "true", 1, 1, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "all-outputs", "false", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "all-outputs", "1", 1, 1, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "all-outputs", "0", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "show-empty", "true", 1, 0, 1, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "show-empty", "\"yes\"", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "reconcile-interval", "15", 1, 0, 0, 15, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "reconcile-interval", "0", 1, 0, 0, 0, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "reconcile-interval", "-5", 1, 0, 0, 0, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "output", "\"DP-1\"", 1, 0, 0, 60, "DP-1", RENDER_MODE_BUTTONS, 0, 0 },
+    { "output", "HDMI-A-1", 1, 0, 0, 60, "HDMI-A-1", RENDER_MODE_BUTTONS, 0, 0 },
+    { "output", "\"\"", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "render-mode", "\"strip\"", 1, 0, 0, 60, "", RENDER_MODE_STRIP, 0, 0 },
+    { "render-mode", "\"buttons\"", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "render-mode", "\"canvas\"", 0, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "stable-layout", "true", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 1, 0 },
+    { "stable-layout", "false", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "max-visible", "20", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 20 },
+    { "max-visible", "-1", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "max-visible", "100000", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, MAX_WORKSPACES },
+    { "format", "\"{bogus}\"", 0, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "format", "{id}", 0, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "format", "\"{id}\"", 1, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+    { "all-outputs", NULL, 0, 0, 0, 60, "", RENDER_MODE_BUTTONS, 0, 0 },
+};
+
+static void test_defaults(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("all-outputs", config.view.all_outputs, 0);
+    CHECK_INT("show-empty", config.view.show_empty, 0);
+    CHECK_INT("reconcile-interval", config.reconcile_interval, DEFAULT_RECONCILE_INTERVAL);
+    CHECK_STR("output", config.output, "");
+    CHECK_INT("render-mode", config.render_mode, RENDER_MODE_BUTTONS);
+    CHECK_INT("stable-layout", config.stable_layout, 0);
+    CHECK_INT("max-visible", config.max_visible, 0);
+}
+
+static void test_cases(void) {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const ConfigCase* c = &cases[i];
+        ModuleConfig config;
+        int failures = test_failures;
+
+        module_config_init(&config);
+        CHECK_INT("known", module_config_set(&config, c->key, c->value) == 0, c->known);
+        CHECK_INT("all-outputs", config.view.all_outputs, c->all_outputs);
+        CHECK_INT("show-empty", config.view.show_empty, c->show_empty);
+        CHECK_INT("reconcile-interval", config.reconcile_interval, c->reconcile_interval);
+        CHECK_STR("output", config.output, c->output);
+        CHECK_INT("render-mode", config.render_mode, c->render_mode);
+        CHECK_INT("stable-layout", config.stable_layout, c->stable_layout);
+        CHECK_INT("max-visible", config.max_visible, c->max_visible);
+
+        if (test_failures != failures) {
+            fprintf(stderr, "  in case: %s = %s\n", c->key, c->value ? c->value : "(null)");
+        }
+    }
+}
+
+// Later entries override earlier ones, other keys are left alone
+static void test_sequence(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    module_config_set(&config, "all-outputs", "true");
+    module_config_set(&config, "output", "\"DP-2\"");
+    module_config_set(&config, "all-outputs", "false");
+    CHECK_INT("all-outputs", config.view.all_outputs, 0);
+    CHECK_STR("output", config.output, "DP-2");
+}
+
+// Monitor names longer than the state can hold are truncated, not overflowed
+static void test_long_output(void) {
+    char value[MONITOR_NAME_MAX * 2];
+    ModuleConfig config;
+
+    memset(value, 'X', sizeof(value) - 1);
+    value[0] = '"';
+    value[sizeof(value) - 2] = '"';
+    value[sizeof(value) - 1] = '\0';
+
+    module_config_init(&config);
+    module_config_set(&config, "output", value);
+    CHECK_INT("output length", strlen(config.output), MONITOR_NAME_MAX - 1);
+}
+
+// format and format-icons, with the \uXXXX escapes Waybar's JSON writer uses
+static void test_format(void) {
+    ModuleConfig config;
+    LabelCache cache = { 0 };
+    module_config_init(&config);
+
+    CHECK_INT("format", module_config_set(&config, "format", "\"{icon} \\\"{windows}\\\"\""), 0);
+    CHECK_INT("format-icons",
+              module_config_set(&config, "format-icons",
+                                "{ \"1\": \"\\uf120\", \"default\": \"\\ud83d\\ude00\",\n"
+                                "  \"persistent\": \"p\" }"),
+              0);
+    label_format_update(&config.label, &cache, 1, 0, 2);
+    CHECK_STR("id icon", cache.text, "\xef\x84\xa0 \"2\"");
+    label_format_update(&config.label, &cache, 2, 0, 0);
+    CHECK_STR("default icon", cache.text, "\xf0\x9f\x98\x80 \"0\"");
+
+    CHECK_INT("empty icons", module_config_set(&config, "format-icons", "{}"), 0);
+    CHECK_INT("non-string icon", module_config_set(&config, "format-icons", "{\"1\": 5}"), -1);
+    CHECK_INT("lone surrogate", module_config_set(&config, "format-icons", "{\"1\": \"\\ud83d\"}"), -1);
+    CHECK_INT("unterminated", module_config_set(&config, "format-icons", "{\"1\": \"x"), -1);
+
+    // A bad object applies none of its icons, not just those before the damage
+    CHECK_INT("bad after good", module_config_set(&config, "format-icons",
+                                                  "{\"2\": \"two\", \"3\": 3}"), -1);
+    label_format_update(&config.label, &cache, 2, 0, 0);
+    CHECK_STR("icons kept", cache.text, "\xf0\x9f\x98\x80 \"0\"");
+    CHECK_INT("trailing comma", module_config_set(&config, "format-icons", "{\"2\": \"two\",}"), -1);
+}
+
+static void test_app_icons(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("app-icons default", config.view.app_icons, 0);
+    CHECK_INT("app-icon-size default", config.app_icon_size, DEFAULT_APP_ICON_SIZE);
+
+    CHECK_INT("app-icons", module_config_set(&config, "app-icons", "true"), 0);
+    CHECK_INT("app-icons value", config.view.app_icons, 1);
+    module_config_set(&config, "app-icon-size", "24");
+    CHECK_INT("app-icon-size", config.app_icon_size, 24);
+    module_config_set(&config, "app-icon-size", "2");
+    CHECK_INT("app-icon-size min", config.app_icon_size, MIN_APP_ICON_SIZE);
+    module_config_set(&config, "app-icon-size", "4096");
+    CHECK_INT("app-icon-size max", config.app_icon_size, MAX_APP_ICON_SIZE);
+}
+
+// Tooltips are on unless turned off, like Waybar's own modules
+static void test_tooltip(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("tooltip default", config.tooltip, 1);
+    CHECK_INT("tooltip", module_config_set(&config, "tooltip", "false"), 0);
+    CHECK_INT("tooltip value", config.tooltip, 0);
+}
+
+// Threshold classes are named after the count; bad arrays change nothing
+static void test_badges(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("badges default", config.badges, 0);
+    CHECK_INT("no thresholds", config.view.count_level_count, 0);
+
+    CHECK_INT("badges", module_config_set(&config, "badges", "true"), 0);
+    CHECK_INT("badges value", config.badges, 1);
+    CHECK_INT("thresholds", module_config_set(&config, "badge-thresholds", "[ 2, 5,10 ]"), 0);
+    CHECK_INT("threshold count", config.view.count_level_count, 3);
+    CHECK_INT("second threshold", config.view.count_levels[1], 5);
+    CHECK_STR("class", config.count_classes[2], "windows-10");
+
+    CHECK_INT("descending", module_config_set(&config, "badge-thresholds", "[5, 2]"), -1);
+    CHECK_INT("zero", module_config_set(&config, "badge-thresholds", "[0]"), -1);
+    CHECK_INT("too many", module_config_set(&config, "badge-thresholds", "[1, 2, 3, 4, 5]"), -1);
+    CHECK_INT("not an array", module_config_set(&config, "badge-thresholds", "3"), -1);
+    CHECK_INT("unterminated", module_config_set(&config, "badge-thresholds", "[1, 2"), -1);
+    CHECK_INT("kept", config.view.count_level_count, 3);
+
+    CHECK_INT("empty", module_config_set(&config, "badge-thresholds", "[]"), 0);
+    CHECK_INT("cleared", config.view.count_level_count, 0);
+}
+
+static void test_urgent_blink(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("urgent-blink default", config.urgent_blink, 0);
+    CHECK_INT("urgent-blink", module_config_set(&config, "urgent-blink", "true"), 0);
+    CHECK_INT("urgent-blink value", config.urgent_blink, 1);
+}
+
+static void test_has_floating(void) {
+    ModuleConfig config;
+    module_config_init(&config);
+    CHECK_INT("has-floating default", config.view.has_floating, 0);
+    CHECK_INT("has-floating", module_config_set(&config, "has-floating", "true"), 0);
+    CHECK_INT("has-floating value", config.view.has_floating, 1);
+}
+
+int main(void) {
+    test_defaults();
+    test_cases();
+    test_sequence();
+    test_long_output();
+    test_format();
+    test_app_icons();
+    test_tooltip();
+    test_badges();
+    test_urgent_blink();
+    test_has_floating();
+    return test_result("config");
+}
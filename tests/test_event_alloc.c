@@ -0,0 +1,89 @@
+/**
+ * Steady-state event path must not allocate.
+ *
+ * Replays a recorded socket2 stream through the same steps as the module's
+ * reader and state worker - event_scan_lines(), event_queue_push_line() and
+ * ws_state_apply_event() - in socket-sized chunks, and fails if any pass
+ * after the warm-up calls the allocator. Allocations are counted by
+ * alloc_shim, which meson preloads with LD_PRELOAD.
+ *
+ * Usage: test_event_alloc STREAM
+ */
+
+#include "test_util.h"
+#include <dlfcn.h>
+#include <stdlib.h>
+
+#define PASSES 20
+
+typedef unsigned long (*AllocCountFunc)(void);
+
+static WorkspaceState state;
+
+// Replay the whole stream in socket-sized reads
+static size_t replay(const char* stream, size_t stream_len) {
+    size_t applied = replay_events(&state, stream, stream_len, REPLAY_BUFFER);
+    // Unresolvable window events would trigger a workspaces query here
+    state.refresh_pending = 0;
+    return applied;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s STREAM\n", argv[0]);
+        return 2;
+    }
+
+    AllocCountFunc alloc_count = (AllocCountFunc)dlsym(RTLD_DEFAULT, "alloc_shim_count");
+    if (!alloc_count) {
+        fprintf(stderr, "alloc_shim is not preloaded (LD_PRELOAD)\n");
+        return 1;
+    }
+
+    FILE* fp = fopen(argv[1], "rb");
+    if (!fp) {
+        perror(argv[1]);
+        return 2;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t stream_len = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* stream = malloc(stream_len);
+    if (!stream || fread(stream, 1, stream_len, fp) != stream_len) {
+        fprintf(stderr, "Failed to read %s\n", argv[1]);
+        return 2;
+    }
+    fclose(fp);
+
+    // Make sure the shim really sees allocations from this binary
+    void* (*volatile probe_malloc)(size_t) = malloc;
+    unsigned long before = alloc_count();
+    free(probe_malloc(16));
+    if (alloc_count() == before) {
+        fprintf(stderr, "alloc_shim is loaded but not intercepting malloc\n");
+        return 1;
+    }
+
+    ws_state_init(&state);
+    strcpy(state.monitor_name, "DP-1");
+    strcpy(state.focused_monitor, "DP-1");
+
+    // Warm-up pass: first-touch of anything lazily set up (e.g. by libc)
+    size_t applied = replay(stream, stream_len);
+
+    before = alloc_count();
+    for (int i = 0; i < PASSES; i++) {
+        replay(stream, stream_len);
+    }
+    unsigned long allocations = alloc_count() - before;
+
+    printf("%zu events/pass x %d passes (%s scanner): %lu allocations\n",
+           applied, PASSES, event_scan_impl(), allocations);
+    free(stream);
+
+    if (applied == 0) {
+        fprintf(stderr, "No events applied - wrong stream?\n");
+        return 1;
+    }
+    return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,304 @@
+/**
+ * Table-driven tests for every socket2 event the module handles.
+ *
+ * Each case starts from the same baseline state and applies its lines
+ * through the scanner, queue and state engine. Expectations left NULL (or
+ * -1) must match the baseline.
+ *
+ * Baseline: this bar is on DP-1 and focused; workspaces 1-2 are on DP-1 and
+ * 3 on HDMI-A-1; windows a1, a2 are on workspace 1, b1 on 3 and c1 on
+ * special:2.
+ */
+
+#include "test_util.h"
+
+// Compact state encodings used by the table
+//   windows/special: one digit per workspace 1-9
+//   monitors: one letter per workspace 1-9 - D = DP-1, H = HDMI-A-1, - = none
+#define BASE_ACTIVE 1
+#define BASE_FOCUSED_HERE 1
+#define BASE_FOCUSED_MONITOR "DP-1"
+#define BASE_WINDOWS "201000000"
+#define BASE_SPECIAL "010000000"
+#define BASE_MONITORS "DDH------"
+
+typedef struct {
+    const char* name;
+    const char* events;           // Lines applied to the baseline
+    int active;                   // this_monitor_workspace, -1 = baseline
+    int focused_here;             // user_focused_here, -1 = baseline
+    const char* focused_monitor;
+    const char* windows;
+    const char* special;
+    const char* monitors;
+    int refresh;                  // Expected refresh_pending
+} EventCase;
+
+static const EventCase cases[] = {
+    { "workspace switch on this monitor", "workspace>>2\n",
+      2, -1, NULL, NULL, NULL, NULL, 0 },
+    { "workspace switch on another monitor", "workspace>>3\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "workspace switch to an unassigned workspace", "workspace>>7\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "workspace switch to a named workspace", "workspace>>music\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "focus moves to another monitor", "focusedmon>>HDMI-A-1,3\n",
+      -1, 0, "HDMI-A-1", NULL, NULL, NULL, 0 },
+    { "focus returns showing a moved workspace", "focusedmon>>HDMI-A-1,3\nfocusedmon>>DP-1,3\n",
+      3, 1, "DP-1", NULL, NULL, "DDD------", 0 },
+    { "focusedmon without workspace", "focusedmon>>DP-1\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "special workspace toggle", "activespecial>>special:2,DP-1\nactivespecial>>,DP-1\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "open window", "openwindow>>d1,2,kitty,~\n",
+      -1, -1, NULL, "211000000", NULL, NULL, 0 },
+    { "open window on a special workspace", "openwindow>>d1,special:4,kitty,~\n",
+      -1, -1, NULL, NULL, "010100000", NULL, 0 },
+    { "open window with commas in the title", "openwindow>>d1,3,firefox,a, b, c\n",
+      -1, -1, NULL, "202000000", NULL, NULL, 0 },
+    { "open window on a named workspace", "openwindow>>d1,music,mpv,song\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "open window with a malformed address", "openwindow>>zz,2,kitty,~\n",
+      -1, -1, NULL, NULL, NULL, NULL, 1 },
+    { "close window", "closewindow>>a1\n",
+      -1, -1, NULL, "101000000", NULL, NULL, 0 },
+    { "close special window", "closewindow>>c1\n",
+      -1, -1, NULL, NULL, "000000000", NULL, 0 },
+    { "close unknown window", "closewindow>>ffff\n",
+      -1, -1, NULL, NULL, NULL, NULL, 1 },
+    { "open then close", "openwindow>>d1,2,kitty,~\nclosewindow>>d1\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "move window", "movewindow>>a1,3\n",
+      -1, -1, NULL, "102000000", NULL, NULL, 0 },
+    { "move window out of a special workspace", "movewindow>>c1,5\n",
+      -1, -1, NULL, "201010000", "000000000", NULL, 0 },
+    { "move unknown window", "movewindow>>ffff,3\n",
+      -1, -1, NULL, NULL, NULL, NULL, 1 },
+    { "window title", "windowtitlev2>>a1,new, title\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "title of an unknown window", "windowtitlev2>>ffff,title\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "create workspace on the focused monitor", "createworkspacev2>>5,5\nworkspace>>5\n",
+      5, -1, NULL, NULL, NULL, "DDH-D----", 0 },
+    { "create workspace after focus moved",
+      "focusedmon>>HDMI-A-1,3\ncreateworkspacev2>>6,6\nworkspace>>6\n",
+      -1, 0, "HDMI-A-1", NULL, NULL, "DDH--H---", 0 },
+    { "create workspace on a rule-bound monitor",
+      "createworkspacev2>>5,5\nfocusedmon>>HDMI-A-1,5\nworkspace>>5\n",
+      -1, 0, "HDMI-A-1", NULL, NULL, "DDH-H----", 0 },
+    { "create workspace without a switch", "createworkspacev2>>5,5\nmovewindow>>a1,5\n",
+      -1, -1, NULL, "101010000", NULL, "DDH-D----", 1 },
+    { "destroy workspace", "destroyworkspacev2>>2,2\n",
+      -1, -1, NULL, NULL, NULL, "D-H------", 0 },
+    { "move workspace", "moveworkspacev2>>3,3,DP-1\n",
+      -1, -1, NULL, NULL, NULL, "DDD------", 0 },
+    { "monitor removed", "monitorremoved>>HDMI-A-1\n",
+      -1, -1, NULL, NULL, NULL, "DD-------", 1 },
+    { "focused monitor removed", "focusedmon>>HDMI-A-1,3\nmonitorremoved>>HDMI-A-1\n",
+      -1, 0, "", NULL, NULL, "DD-------", 1 },
+    { "ignored events", "workspacev2>>2,2\nactivewindow>>kitty,~\nwindowtitle>>a1\n"
+      "createworkspace>>5\nmoveworkspace>>3,DP-1\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+    { "lines without a separator", "workspace\nworkspace 2\n\n",
+      -1, -1, NULL, NULL, NULL, NULL, 0 },
+};
+
+static void setup_baseline(WorkspaceState* st) {
+    ws_state_init(st);
+    strcpy(st->monitor_name, "DP-1");
+    strcpy(st->focused_monitor, BASE_FOCUSED_MONITOR);
+    st->this_monitor_workspace = BASE_ACTIVE;
+    st->user_focused_here = BASE_FOCUSED_HERE;
+
+    ws_state_set_workspace_monitor(st, 1, "DP-1");
+    ws_state_set_workspace_monitor(st, 2, "DP-1");
+    ws_state_set_workspace_monitor(st, 3, "HDMI-A-1");
+
+    // Counts come from the workspaces reply, the table from the clients reply
+    st->workspace_windows[0] = 2;
+    st->workspace_windows[2] = 1;
+    st->special_windows[1] = 1;
+    ws_state_add_window(st, 0xa1, 1, 0, 0, NULL);
+    ws_state_add_window(st, 0xa2, 1, 0, 0, NULL);
+    ws_state_add_window(st, 0xb1, 3, 0, 0, NULL);
+    ws_state_add_window(st, 0xc1, -2, 0, 0, NULL);
+}
+
+static void encode_counts(const int* counts, char* out) {
+    for (int i = 0; i < NUM_PERSISTENT_WORKSPACES; i++) {
+        out[i] = (char)('0' + (counts[i] > 9 ? 9 : counts[i]));
+    }
+    out[NUM_PERSISTENT_WORKSPACES] = '\0';
+}
+
+static void encode_monitors(const WorkspaceState* st, char* out) {
+    for (int i = 0; i < NUM_PERSISTENT_WORKSPACES; i++) {
+        const char* mon = st->workspace_monitor[i];
+        out[i] = strcmp(mon, "DP-1") == 0 ? 'D' : strcmp(mon, "HDMI-A-1") == 0 ? 'H' :
+                 mon[0] == '\0' ? '-' : '?';
+    }
+    out[NUM_PERSISTENT_WORKSPACES] = '\0';
+}
+
+static void run_case(const EventCase* c) {
+    static WorkspaceState st;
+    char actual[NUM_PERSISTENT_WORKSPACES + 1];
+    int failures = test_failures;
+
+    setup_baseline(&st);
+    replay_events(&st, c->events, strlen(c->events), 0);
+
+    CHECK_INT("active", st.this_monitor_workspace, c->active >= 0 ? c->active : BASE_ACTIVE);
+    CHECK_INT("focused here", st.user_focused_here,
+              c->focused_here >= 0 ? c->focused_here : BASE_FOCUSED_HERE);
+    CHECK_STR("focused monitor", st.focused_monitor,
+              c->focused_monitor ? c->focused_monitor : BASE_FOCUSED_MONITOR);
+    encode_counts(st.workspace_windows, actual);
+    CHECK_STR("windows", actual, c->windows ? c->windows : BASE_WINDOWS);
+    encode_counts(st.special_windows, actual);
+    CHECK_STR("special", actual, c->special ? c->special : BASE_SPECIAL);
+    encode_monitors(&st, actual);
+    CHECK_STR("monitors", actual, c->monitors ? c->monitors : BASE_MONITORS);
+    CHECK_INT("refresh pending", st.refresh_pending, c->refresh);
+
+    if (test_failures != failures) {
+        fprintf(stderr, "  in case: %s\n", c->name);
+    }
+}
+
+// Events arriving before the monitor is known are dropped - the first
+// fetch after detection covers them
+static void test_undetected_monitor(void) {
+    static WorkspaceState st;
+    const char* events = "workspace>>2\nfocusedmon>>HDMI-A-1,3\nopenwindow>>d1,2,kitty,~\n";
+
+    ws_state_init(&st);
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("active", st.this_monitor_workspace, 1);
+    CHECK_INT("windows on 2", st.workspace_windows[1], 0);
+    CHECK_INT("window table", st.window_count, 0);
+}
+
+// Bit i set: workspace i + 1 has the class
+static unsigned class_mask(const WorkspaceState* st, unsigned cls) {
+    static WorkspaceRender render;
+    WorkspaceViewConfig view = { .all_outputs = 1, .show_empty = 1, .has_floating = 1 };
+    unsigned mask = 0;
+    ws_state_render(st, &view, &render);
+    for (int i = 0; i < NUM_PERSISTENT_WORKSPACES; i++) {
+        if (render.buttons[i].classes & cls) mask |= 1u << i;
+    }
+    return mask;
+}
+
+static unsigned urgent_classes(const WorkspaceState* st) {
+    return class_mask(st, WS_CLASS_URGENT);
+}
+
+// urgent>> marks the window's workspace (special:N marks N) until the window
+// is focused, closed or reseeded; it follows moves
+static void test_urgent(void) {
+    static WorkspaceState st;
+    const char* events;
+    setup_baseline(&st);
+
+    events = "urgent>>a1\nurgent>>c1\nurgent>>ffff\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("urgent 1 and 2", urgent_classes(&st), 0x3);
+    CHECK_INT("unknown window not queried", st.refresh_pending, 0);
+
+    events = "movewindow>>a1,3\nurgent>>a1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("moved", urgent_classes(&st), 0x6);
+
+    events = "activewindowv2>>a2\nactivewindowv2>>a1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("focused", urgent_classes(&st), 0x2);
+
+    events = "closewindow>>c1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("closed", urgent_classes(&st), 0);
+
+    // Only urgency changes touch the render
+    HyprEvent event = { .type = EVENT_URGENT };
+    strcpy(event.payload, "b1");
+    CHECK_INT("urgent changes render", ws_state_apply_event(&st, &event), 1);
+    CHECK_INT("urgent again", ws_state_apply_event(&st, &event), 0);
+    event.type = EVENT_ACTIVEWINDOW;
+    strcpy(event.payload, "a2");
+    CHECK_INT("plain focus change", ws_state_apply_event(&st, &event), 0);
+    strcpy(event.payload, "b1");
+    CHECK_INT("focus clears", ws_state_apply_event(&st, &event), 1);
+
+    ws_state_apply_event(&st, &(HyprEvent){ .type = EVENT_URGENT, .payload = "a2" });
+    ws_state_clear_windows(&st);
+    CHECK_INT("reseeded", urgent_classes(&st), 0);
+}
+
+// fullscreen>> applies to the window activewindowv2 last focused;
+// changefloatingmode>> names its window. Neither ever asks for a query.
+static void test_fullscreen_floating(void) {
+    static WorkspaceState st;
+    const char* events;
+    setup_baseline(&st);
+
+    events = "activewindowv2>>a1\nfullscreen>>1\nchangefloatingmode>>b1,1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("fullscreen 1", class_mask(&st, WS_CLASS_FULLSCREEN), 0x1);
+    CHECK_INT("floating 3", class_mask(&st, WS_CLASS_HAS_FLOATING), 0x4);
+
+    // Special windows don't mark N
+    events = "activewindowv2>>c1\nfullscreen>>1\nchangefloatingmode>>c1,1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("special fullscreen", class_mask(&st, WS_CLASS_FULLSCREEN), 0x1);
+    CHECK_INT("special floating", class_mask(&st, WS_CLASS_HAS_FLOATING), 0x4);
+
+    // Flags follow windows, and count once off the special workspace
+    events = "movewindow>>a1,2\nmovewindow>>c1,2\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("moved fullscreen", class_mask(&st, WS_CLASS_FULLSCREEN), 0x2);
+    CHECK_INT("moved floating", class_mask(&st, WS_CLASS_HAS_FLOATING), 0x6);
+
+    events = "activewindowv2>>a1\nfullscreen>>0\nactivewindowv2>>c1\nfullscreen>>0\n"
+             "closewindow>>b1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("left fullscreen", class_mask(&st, WS_CLASS_FULLSCREEN), 0);
+    CHECK_INT("closed floating", class_mask(&st, WS_CLASS_HAS_FLOATING), 0x2);
+
+    // Toggling fullscreen only touches the render; unknown windows change nothing
+    HyprEvent event = { .type = EVENT_FULLSCREEN, .payload = "1" };
+    CHECK_INT("enter", ws_state_apply_event(&st, &event), 1);
+    CHECK_INT("enter again", ws_state_apply_event(&st, &event), 0);
+    strcpy(event.payload, "0");
+    CHECK_INT("leave", ws_state_apply_event(&st, &event), 1);
+    events = "activewindowv2>>ffff\nfullscreen>>1\nchangefloatingmode>>eeee,1\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("unknown windows", class_mask(&st, WS_CLASS_FULLSCREEN), 0);
+    CHECK_INT("never queried", st.refresh_pending, 0);
+    CHECK_INT("no flags query", st.flags_pending, 0);
+
+    // A new window's floating state takes a clients query; a reseed covers it
+    events = "openwindow>>d1,3,mpv,song\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("opened", st.flags_pending, 1);
+    CHECK_INT("opened no refresh", st.refresh_pending, 0);
+    ws_state_clear_windows(&st);
+    CHECK_INT("reseeded", st.flags_pending, 0);
+
+    // has-floating is opt-in
+    static WorkspaceRender render;
+    WorkspaceViewConfig view = { .all_outputs = 1, .show_empty = 1 };
+    ws_state_render(&st, &view, &render);
+    CHECK_INT("has-floating off", render.buttons[1].classes & WS_CLASS_HAS_FLOATING, 0);
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        run_case(&cases[i]);
+    }
+    test_undetected_monitor();
+    test_urgent();
+    test_fullscreen_floating();
+    return test_result("events");
+}
@@ -0,0 +1,280 @@
+/**
+ * IPC client stress test, meant to run under TSan and ASan as well.
+ *
+ * Starts the reader and state worker against a fake socket2 server that
+ * streams random event bursts and drops the connection every few bursts,
+ * while the main thread plays the UI: it suspends and resumes the client and
+ * reads the published render after every commit. hyprctl is replaced by the
+ * canned script in tests/fake-hyprland. Finally the server sends a known
+ * focus change and the published render must settle on it.
+ *
+ * Usage: test_ipc_stress FAKE_HYPRCTL_DIR
+ */
+
+#include "ipc_client.h"
+#include "test_util.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STRESS_MS 1500
+#define SETTLE_MS 10000
+#define SUSPEND_EVERY_MS 120
+#define BURSTS_PER_CONNECTION 40
+#define BURST_LINES 64
+
+typedef struct {
+    int listen_fd;
+    atomic_int stop;
+    atomic_int final_phase;   // Stop the random bursts, repeat the final events
+    atomic_ulong lines_sent;
+    atomic_ulong connections;
+} FakeServer;
+
+static int commit_fd = -1;
+static char runtime_dir[] = "/tmp/test_ipc_stress.XXXXXX";
+
+static int64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// IpcCommitFunc: wake the "UI" thread like the module's GSource does
+static void on_commit(void* user_data) {
+    uint64_t one = 1;
+    (void)user_data;
+    if (write(commit_fd, &one, sizeof(one)) < 0) {
+        // Counter saturated; the reader is awake anyway
+    }
+}
+
+static unsigned next_random(unsigned* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16) & 0x7fff;
+}
+
+// One random event line, including events the module ignores and junk
+static int random_line(unsigned* seed, char* out, size_t out_size) {
+    static const char* monitors[] = { "DP-1", "HDMI-A-1", "eDP-1" };
+    unsigned r = next_random(seed);
+    unsigned ws = 1 + next_random(seed) % 12;
+    unsigned addr = 0x1000 + next_random(seed) % 64;
+    const char* mon = monitors[next_random(seed) % 3];
+
+    switch (r % 12) {
+    case 0: return snprintf(out, out_size, "workspace>>%u\n", ws);
+    case 1: return snprintf(out, out_size, "focusedmon>>%s,%u\n", mon, ws);
+    case 2: return snprintf(out, out_size, "openwindow>>%x,%u,kitty,title %u\n", addr, ws, r);
+    case 3: return snprintf(out, out_size, "closewindow>>%x\n", addr);
+    case 4: return snprintf(out, out_size, "movewindow>>%x,%u\n", addr, ws);
+    case 5: return snprintf(out, out_size, "createworkspacev2>>%u,%u\n", ws, ws);
+    case 6: return snprintf(out, out_size, "destroyworkspacev2>>%u,%u\n", ws, ws);
+    case 7: return snprintf(out, out_size, "moveworkspacev2>>%u,%u,%s\n", ws, ws, mon);
+    case 8: return snprintf(out, out_size, "activespecial>>special:%u,%s\n", ws % 9 + 1, mon);
+    case 9: return snprintf(out, out_size, "activewindow>>kitty,%u\n", r);
+    case 10: return snprintf(out, out_size, "windowtitlev2>>%x,title %u\n", addr, r);
+    default: return snprintf(out, out_size, "no separator %u\n", r);
+    }
+}
+
+static int send_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void* server_thread(void* arg) {
+    FakeServer* server = arg;
+    unsigned seed = 42;
+    char burst[BURST_LINES * 64];
+
+    while (!atomic_load(&server->stop)) {
+        struct pollfd pfd = { .fd = server->listen_fd, .events = POLLIN };
+        if (poll(&pfd, 1, 50) <= 0) continue;
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        atomic_fetch_add(&server->connections, 1);
+
+        // Random bursts, then hang up; the client has to reconnect and resync
+        for (int i = 0; i < BURSTS_PER_CONNECTION && !atomic_load(&server->final_phase); i++) {
+            size_t len = 0;
+            for (int j = 0; j < BURST_LINES; j++) {
+                len += (size_t)random_line(&seed, burst + len, sizeof(burst) - len);
+            }
+            // Split mid-line so the reader has to carry partial lines over
+            size_t split = len / 3;
+            if (send_all(fd, burst, split) < 0 || send_all(fd, burst + split, len - split) < 0) break;
+            atomic_fetch_add(&server->lines_sent, BURST_LINES);
+            usleep(500);
+        }
+
+        // Final phase: keep this connection and repeat a known focus change
+        // until the test is satisfied (a resync may overwrite earlier copies)
+        while (atomic_load(&server->final_phase) && !atomic_load(&server->stop)) {
+            static const char final_events[] = "focusedmon>>DP-1,4\nworkspace>>4\n";
+            if (send_all(fd, final_events, sizeof(final_events) - 1) < 0) break;
+            usleep(20000);
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+// Invariants every published render must hold, however it raced
+static void check_render(const WorkspaceRender* render) {
+    int focused = 0;
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        unsigned classes = render->buttons[i].classes;
+        if (!render->buttons[i].shown) continue;
+        CHECK((classes & ~(unsigned)(WS_CLASS_ACTIVE | WS_CLASS_VISIBLE | WS_CLASS_EMPTY |
+                                     WS_CLASS_HAS_SPECIAL)) == 0);
+        CHECK(!((classes & WS_CLASS_ACTIVE) && (classes & WS_CLASS_VISIBLE)));
+        if (classes & (WS_CLASS_ACTIVE | WS_CLASS_VISIBLE)) focused++;
+    }
+    CHECK(focused <= 1);
+}
+
+static int setup_environment(const char* fake_dir, char* socket_path, size_t socket_path_size) {
+    if (!mkdtemp(runtime_dir)) {
+        perror("mkdtemp");
+        return -1;
+    }
+    char hypr_dir[256];
+    snprintf(hypr_dir, sizeof(hypr_dir), "%s/hypr", runtime_dir);
+    mkdir(hypr_dir, 0700);
+    snprintf(hypr_dir, sizeof(hypr_dir), "%s/hypr/stress", runtime_dir);
+    mkdir(hypr_dir, 0700);
+    snprintf(socket_path, socket_path_size, "%s/hypr/stress/.socket2.sock", runtime_dir);
+
+    setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+    setenv("HYPRLAND_INSTANCE_SIGNATURE", "stress", 1);
+
+    // The client runs hyprctl through popen(); put the fake one first
+    char path[4096];
+    const char* old_path = getenv("PATH");
+    snprintf(path, sizeof(path), "%s:%s", fake_dir, old_path ? old_path : "/usr/bin:/bin");
+    setenv("PATH", path, 1);
+    return 0;
+}
+
+static int listen_unix(const char* socket_path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+        perror("fake socket2");
+        return -1;
+    }
+    return fd;
+}
+
+// Wait for a commit notification (or timeout) and check what was published
+static void ui_iteration(IpcClient* client, WorkspaceRender* render, int timeout_ms) {
+    struct pollfd pfd = { .fd = commit_fd, .events = POLLIN };
+    if (poll(&pfd, 1, timeout_ms) > 0) {
+        uint64_t count;
+        if (read(commit_fd, &count, sizeof(count)) < 0) {
+            // Spurious wakeup
+        }
+    }
+    ipc_client_render(client, render);
+    check_render(render);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s FAKE_HYPRCTL_DIR\n", argv[0]);
+        return 2;
+    }
+
+    char socket_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    if (setup_environment(argv[1], socket_path, sizeof(socket_path)) < 0) return 1;
+
+    FakeServer server = { .listen_fd = listen_unix(socket_path) };
+    if (server.listen_fd < 0) return 1;
+    commit_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    ModuleConfig config;
+    module_config_init(&config);
+    config.reconcile_interval = 0;
+
+    static IpcClient client;
+    if (ipc_client_init(&client, &config, on_commit, NULL) < 0) return 1;
+    snprintf(client.state.monitor_name, sizeof(client.state.monitor_name), "DP-1");
+    ipc_client_fetch(&client);
+
+    pthread_t server_tid;
+    pthread_create(&server_tid, NULL, server_thread, &server);
+    CHECK_INT("ipc_client_start", ipc_client_start(&client), 0);
+
+    // Stress: random bursts and hang-ups, plus suspend/resume from the UI side
+    WorkspaceRender render;
+    int64_t start = now_ms();
+    int64_t next_toggle = start + SUSPEND_EVERY_MS;
+    int suspended = 0;
+    unsigned long renders = 0;
+    while (now_ms() - start < STRESS_MS) {
+        ui_iteration(&client, &render, 10);
+        renders++;
+        if (now_ms() >= next_toggle) {
+            suspended = !suspended;
+            ipc_client_set_suspended(&client, suspended);
+            next_toggle = now_ms() + SUSPEND_EVERY_MS;
+        }
+    }
+    ipc_client_set_suspended(&client, 0);
+
+    // Settle: the last thing Hyprland said was "DP-1 focused, workspace 4"
+    atomic_store(&server.final_phase, 1);
+    int settled = 0;
+    start = now_ms();
+    while (!settled && now_ms() - start < SETTLE_MS) {
+        ui_iteration(&client, &render, 50);
+        settled = render.buttons[3].shown && (render.buttons[3].classes & WS_CLASS_ACTIVE);
+    }
+    CHECK(settled);
+    for (int i = 0; i < MAX_WORKSPACES; i++) {
+        if (i != 3) CHECK(!(render.buttons[i].classes & (WS_CLASS_ACTIVE | WS_CLASS_VISIBLE)));
+    }
+
+    atomic_store(&server.stop, 1);
+    pthread_join(server_tid, NULL);
+
+    CHECK(atomic_load(&server.connections) > 1);
+    CHECK(atomic_load(&client.stats.events) > 0);
+    CHECK(atomic_load(&client.stats.resyncs) > 0);
+    // Floods are parked or coalesced; what still overflows costs one resync,
+    // which covers the events behind it instead of overflowing again
+    unsigned long dropped = atomic_load(&client.queue.dropped);
+    CHECK(dropped <= atomic_load(&client.stats.resyncs));
+    CHECK(dropped * 100 <= atomic_load(&server.lines_sent));
+    printf("lines=%lu connections=%lu renders=%lu\n", atomic_load(&server.lines_sent),
+           atomic_load(&server.connections), renders);
+    ipc_client_print_stats(&client, stdout, "stress:");
+
+    ipc_client_destroy(&client);
+    close(server.listen_fd);
+    close(commit_fd);
+    unlink(socket_path);
+    char dir[256];
+    snprintf(dir, sizeof(dir), "%s/hypr/stress", runtime_dir);
+    rmdir(dir);
+    snprintf(dir, sizeof(dir), "%s/hypr", runtime_dir);
+    rmdir(dir);
+    rmdir(runtime_dir);
+    return test_result("ipc_stress");
+}
@@ -0,0 +1,124 @@
+/**
+ * Label templates: compiling formats, icon selection, and the cache that
+ * decides whether a slot has to be relabelled at all.
+ */
+
+#include "label_format.h"
+#include "test_util.h"
+
+typedef struct {
+    const char* format;
+    int workspace;
+    unsigned classes;
+    int windows;
+    const char* expected;      // NULL: the format must be rejected
+} FormatCase;
+
+// Icons: active "A", empty "E", default "D", workspace 3 "three"
+static const FormatCase cases[] = {
+    { "{id}", 7, 0, 2, "7" },
+    { "{name}", 12, 0, 0, "12" },
+    { "{id}: {windows}", 4, 0, 3, "4: 3" },
+    { "[{icon}]", 3, 0, 1, "[three]" },
+    { "{icon}", 3, WS_CLASS_ACTIVE, 1, "A" },
+    { "{icon}", 5, WS_CLASS_EMPTY, 0, "E" },
+    { "{icon}", 5, 0, 1, "D" },
+    { "{icon}", 5, WS_CLASS_VISIBLE, 1, "D" },
+    { "{{{id}}}", 2, 0, 0, "{2}" },
+    { "plain", 2, 0, 0, "plain" },
+    { "", 2, 0, 0, "" },
+    { "{bogus}", 1, 0, 0, NULL },
+    { "{id", 1, 0, 0, NULL },
+    { "id}", 1, 0, 0, NULL },
+    { "{}", 1, 0, 0, NULL },
+};
+
+static void set_icons(LabelFormat* fmt) {
+    CHECK_INT("active icon", label_format_set_icon(fmt, "active", "A"), 0);
+    CHECK_INT("empty icon", label_format_set_icon(fmt, "empty", "E"), 0);
+    CHECK_INT("default icon", label_format_set_icon(fmt, "default", "D"), 0);
+    CHECK_INT("id icon", label_format_set_icon(fmt, "3", "three"), 0);
+    CHECK_INT("unknown key", label_format_set_icon(fmt, "persistent", "P"), -1);
+    CHECK_INT("id out of range", label_format_set_icon(fmt, "0", "Z"), -1);
+}
+
+static void test_cases(void) {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const FormatCase* c = &cases[i];
+        LabelFormat fmt;
+        LabelCache cache = { 0 };
+        int failures = test_failures;
+
+        label_format_init(&fmt);
+        set_icons(&fmt);
+        int compiled = label_format_compile(&fmt, c->format);
+        CHECK_INT("compiled", compiled == 0, c->expected != NULL);
+        if (compiled == 0 && c->expected) {
+            label_format_update(&fmt, &cache, c->workspace, c->classes, c->windows);
+            CHECK_STR("text", cache.text, c->expected);
+        }
+        if (test_failures != failures) {
+            fprintf(stderr, "  in case: %s\n", c->format);
+        }
+    }
+}
+
+// A rejected format leaves the previous one in place
+static void test_reject_keeps(void) {
+    LabelFormat fmt;
+    LabelCache cache = { 0 };
+    label_format_init(&fmt);
+    label_format_compile(&fmt, "<{id}>");
+    label_format_compile(&fmt, "{nope}");
+    label_format_update(&fmt, &cache, 6, 0, 0);
+    CHECK_STR("text", cache.text, "<6>");
+}
+
+// Only inputs the format uses, and only a different final text, count
+static void test_cache(void) {
+    LabelFormat fmt;
+    LabelCache cache = { 0 };
+    label_format_init(&fmt);
+
+    CHECK_INT("first render", label_format_update(&fmt, &cache, 1, 0, 0), 1);
+    CHECK_INT("same inputs", label_format_update(&fmt, &cache, 1, 0, 0), 0);
+    CHECK_INT("unused inputs", label_format_update(&fmt, &cache, 1, WS_CLASS_ACTIVE, 5), 0);
+    CHECK_INT("new id", label_format_update(&fmt, &cache, 2, 0, 0), 1);
+
+    // {icon} depends on classes, but the default icon doesn't change with them
+    label_format_compile(&fmt, "{icon}");
+    label_format_set_icon(&fmt, "default", "D");
+    memset(&cache, 0, sizeof(cache));
+    CHECK_INT("icon first render", label_format_update(&fmt, &cache, 1, 0, 0), 1);
+    CHECK_INT("icon same text", label_format_update(&fmt, &cache, 1, WS_CLASS_EMPTY, 0), 0);
+    label_format_set_icon(&fmt, "active", "A");
+    CHECK_INT("icon active", label_format_update(&fmt, &cache, 1, WS_CLASS_ACTIVE, 0), 1);
+    CHECK_STR("icon text", cache.text, "A");
+}
+
+// Long output is cut at a character boundary, never mid UTF-8 sequence
+static void test_truncation(void) {
+    LabelFormat fmt;
+    LabelCache cache = { 0 };
+    label_format_init(&fmt);
+    // 40 two-byte characters, twice: 160 bytes
+    char icon[81];
+    for (int i = 0; i < 40; i++) {
+        icon[2 * i] = (char)0xC3;
+        icon[2 * i + 1] = (char)0xA9;
+    }
+    icon[80] = '\0';
+    label_format_set_icon(&fmt, "default", icon);
+    label_format_compile(&fmt, "xy{icon}{icon}");
+    label_format_update(&fmt, &cache, 1, 0, 0);
+    CHECK_INT("length", strlen(cache.text), LABEL_TEXT_MAX - 2);
+    CHECK_INT("last byte", (unsigned char)cache.text[strlen(cache.text) - 1], 0xA9);
+}
+
+int main(void) {
+    test_cases();
+    test_reject_keeps();
+    test_cache();
+    test_truncation();
+    return test_result("label_format");
+}
@@ -0,0 +1,284 @@
+/**
+ * Parser edge cases: hyprctl replies that are valid, truncated at every
+ * possible byte, or oddly formatted, and socket2 streams split into reads
+ * at arbitrary points.
+ *
+ * Usage: test_parse STREAM
+ */
+
+#include "hyprctl_parse.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+static const char workspaces_reply[] =
+    "[{\n"
+    "    \"id\": 1,\n"
+    "    \"name\": \"1\",\n"
+    "    \"monitor\": \"DP-1\",\n"
+    "    \"monitorID\": 0,\n"
+    "    \"windows\": 2,\n"
+    "    \"hasfullscreen\": false,\n"
+    "    \"lastwindow\": \"0x55d0c8a20a40\",\n"
+    "    \"lastwindowtitle\": \"say \\\"hi\\\" [1] {x}\"\n"
+    "},{\n"
+    "    \"id\": 3, \"name\": \"3\", \"monitor\": \"HDMI-A-1\", \"windows\": 1,\n"
+    "    \"hasfullscreen\": true\n"
+    "},{\n"
+    "    \"id\": -98, \"name\": \"special:2\", \"monitor\": \"DP-1\", \"windows\": 4\n"
+    "},{\n"
+    "    \"id\": 12, \"name\": \"12\", \"monitor\": \"DP-1\", \"windows\": 5\n"
+    "}]\n";
+
+static const char clients_reply[] =
+    "[{\n"
+    "    \"address\": \"0x55d0c8a20a40\",\n"
+    "    \"mapped\": true,\n"
+    "    \"at\": [0, 0],\n"
+    "    \"size\": [1280, 1440],\n"
+    "    \"workspace\": {\"id\": 1, \"name\": \"1\"},\n"
+    "    \"title\": \"} ] \\\" {\",\n"
+    "    \"floating\": true,\n"
+    "    \"fullscreen\": 2,\n"
+    "    \"grouped\": []\n"
+    "},{\n"
+    "    \"workspace\": {\"id\": -98, \"name\": \"special:2\"},\n"
+    "    \"floating\": false, \"fullscreen\": true,\n"
+    "    \"address\": \"0x55d0c8a22480\"\n"
+    "},{\n"
+    "    \"address\": \"0x55d0c8a23ec0\",\n"
+    "    \"workspace\": {\"id\": 10, \"name\": \"music\"}\n"
+    "}]\n";
+
+static void test_workspaces(void) {
+    WorkspaceSnapshot snap;
+
+    CHECK_INT("parse", hyprctl_parse_workspaces(workspaces_reply, &snap), 0);
+    CHECK_INT("ws 1 windows", snap.workspace_windows[0], 2);
+    CHECK_INT("ws 3 windows", snap.workspace_windows[2], 1);
+    CHECK_INT("special:2 windows", snap.special_windows[1], 4);
+    CHECK_STR("ws 1 monitor", snap.workspace_monitor[0], "DP-1");
+    CHECK_STR("ws 3 monitor", snap.workspace_monitor[2], "HDMI-A-1");
+    CHECK_STR("ws 2 monitor", snap.workspace_monitor[1], "");
+    CHECK_INT("ws 1 fullscreen", snap.has_fullscreen[0], 0);
+    CHECK_INT("ws 3 fullscreen", snap.has_fullscreen[2], 1);
+
+    CHECK_INT("empty list", hyprctl_parse_workspaces(" [ ] ", &snap), 0);
+    CHECK_INT("not a list", hyprctl_parse_workspaces("{}", &snap), -1);
+    CHECK_INT("empty reply", hyprctl_parse_workspaces("", &snap), -1);
+    CHECK_INT("error text", hyprctl_parse_workspaces("unknown request", &snap), -1);
+}
+
+static void test_clients(void) {
+    static WorkspaceState st;
+    ws_state_init(&st);
+
+    CHECK_INT("parse", hyprctl_parse_clients(clients_reply, &st), 0);
+    CHECK_INT("window count", st.window_count, 3);
+    CHECK_INT("ws 1 fullscreen", st.fullscreen_windows[0], 1);
+    CHECK_INT("ws 1 floating", st.floating_windows[0], 1);
+    CHECK_INT("special fullscreen", st.fullscreen_windows[1], 0);
+
+    // The table resolves the addresses: closing them updates the right counts
+    st.workspace_windows[0] = 1;
+    st.special_windows[1] = 1;
+    strcpy(st.monitor_name, "DP-1");
+    const char* events = "closewindow>>55d0c8a20a40\nclosewindow>>55d0c8a22480\n"
+                         "closewindow>>55d0c8a23ec0\n";
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("ws 1 windows", st.workspace_windows[0], 0);
+    CHECK_INT("special:2 windows", st.special_windows[1], 0);
+    CHECK_INT("refresh pending", st.refresh_pending, 0);
+    CHECK_INT("window count", st.window_count, 0);
+    CHECK_INT("fullscreen closed", st.fullscreen_windows[0], 0);
+    CHECK_INT("floating closed", st.floating_windows[0], 0);
+}
+
+// Reconcile takes window flags from the clients reply into the table: windows
+// that opened fullscreen or floating without an event aren't drift
+static void test_client_flags(void) {
+    static WorkspaceState st;
+    WorkspaceSnapshot before, after;
+    int changed;
+    const char* events = "openwindow>>55d0c8a20a40,1,kitty,~\n";
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    hyprctl_parse_clients(clients_reply, &st);
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_INT("opened without flags", st.fullscreen_windows[0] + st.floating_windows[0], 0);
+    ws_state_snapshot(&st, &before);
+
+    // Without has-floating only fullscreen is taken
+    CHECK_INT("parse", hyprctl_parse_client_flags(clients_reply, &st, WINDOW_FULLSCREEN, &changed), 0);
+    CHECK_INT("changed", changed, 1);
+    CHECK_INT("ws 1 fullscreen", st.fullscreen_windows[0], 1);
+    CHECK_INT("ws 1 floating", st.floating_windows[0], 0);
+    CHECK_INT("special not counted", st.fullscreen_windows[1], 0);
+
+    CHECK_INT("parse", hyprctl_parse_client_flags(clients_reply, &st,
+                                                  WINDOW_FULLSCREEN | WINDOW_FLOATING, &changed), 0);
+    CHECK_INT("changed", changed, 1);
+    CHECK_INT("ws 1 floating", st.floating_windows[0], 1);
+    CHECK_INT("parse", hyprctl_parse_client_flags(clients_reply, &st,
+                                                  WINDOW_FULLSCREEN | WINDOW_FLOATING, &changed), 0);
+    CHECK_INT("unchanged", changed, 0);
+
+    // Counts and monitors hash the same either way
+    ws_state_snapshot(&st, &after);
+    CHECK(ws_snapshot_hash(&before) == ws_snapshot_hash(&after));
+}
+
+// Workspaces events can't follow don't count as drift: a renamed one (events
+// and clients name it "music", the reply files it under id 4) and one created
+// on an unfocused monitor that no event has placed yet
+static void test_reconcile_untracked(void) {
+    static WorkspaceState st;
+    WorkspaceSnapshot truth, model;
+    const char* before = "[{\"id\": 1, \"name\": \"1\", \"monitor\": \"DP-1\", \"windows\": 1},"
+                         " {\"id\": 4, \"name\": \"music\", \"monitor\": \"DP-1\", \"windows\": 1}]";
+    const char* after = "[{\"id\": 1, \"name\": \"1\", \"monitor\": \"DP-1\", \"windows\": 1},"
+                        " {\"id\": 4, \"name\": \"music\", \"monitor\": \"DP-1\", \"windows\": 2},"
+                        " {\"id\": 5, \"name\": \"5\", \"monitor\": \"HDMI-A-1\", \"windows\": 0}]";
+    const char* events = "openwindow>>a1,music,mpv,song\ncreateworkspacev2>>5,5\n";
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    strcpy(st.focused_monitor, "DP-1");
+    CHECK_INT("parse before", hyprctl_parse_workspaces(before, &truth), 0);
+    CHECK_INT("renamed untracked", truth.untracked[3], 1);
+    CHECK_INT("numeric tracked", truth.untracked[0], 0);
+    ws_state_apply_snapshot(&st, &truth);
+    replay_events(&st, events, strlen(events), 0);
+    CHECK_STR("ws 5 guessed", st.workspace_monitor[4], "DP-1");
+
+    CHECK_INT("parse after", hyprctl_parse_workspaces(after, &truth), 0);
+    ws_state_snapshot(&st, &model);
+    ws_snapshot_merge_untracked(&truth, &model);
+    CHECK(ws_snapshot_hash(&truth) == ws_snapshot_hash(&model));
+
+    // A missed window on a tracked workspace still is drift
+    st.workspace_windows[0] = 2;
+    ws_state_snapshot(&st, &model);
+    ws_snapshot_merge_untracked(&truth, &model);
+    CHECK(ws_snapshot_hash(&truth) != ws_snapshot_hash(&model));
+}
+
+// Every proper prefix of a reply is rejected, and parsing it stays in bounds
+// (run under ASan to catch overreads: each prefix gets its own allocation)
+static void test_truncated(const char* reply, int (*parse)(const char*, void*), const char* what) {
+    size_t len = strlen(reply);
+    size_t end = len;
+
+    // Trailing whitespace after the closing bracket doesn't matter
+    while (end > 0 && (reply[end - 1] == '\n' || reply[end - 1] == ' ')) end--;
+
+    for (size_t cut = 0; cut < end; cut++) {
+        char* prefix = malloc(cut + 1);
+        memcpy(prefix, reply, cut);
+        prefix[cut] = '\0';
+        if (parse(prefix, NULL) != -1) {
+            fprintf(stderr, "%s: prefix of %zu bytes accepted\n", what, cut);
+            test_failures++;
+        }
+        free(prefix);
+    }
+}
+
+static int parse_workspaces_any(const char* json, void* unused) {
+    WorkspaceSnapshot snap;
+    return hyprctl_parse_workspaces(json, &snap);
+}
+
+static int parse_clients_any(const char* json, void* unused) {
+    static WorkspaceState st;
+    return hyprctl_parse_clients(json, &st);
+}
+
+static int parse_client_flags_any(const char* json, void* unused) {
+    static WorkspaceState st;
+    int changed;
+    return hyprctl_parse_client_flags(json, &st, WINDOW_FULLSCREEN | WINDOW_FLOATING, &changed);
+}
+
+// Splitting a stream into reads at any point must not change the result
+static void test_fragmented(const char* stream, size_t stream_len) {
+    static WorkspaceState whole;
+    static WorkspaceState split;
+    static const size_t chunks[] = { 1, 2, 3, 7, 64, 255, 1000, 4095 };
+    const char* small = "workspace>>2\nfocusedmon>>HDMI-A-1,3\nopenwindow>>d1,3,kitty,a>>b\n"
+                        "windowtitle>>d1\nmovewindow>>d1,2\nclosewindow>>d1\n";
+
+    for (size_t n = 0; n < sizeof(chunks) / sizeof(chunks[0]); n++) {
+        ws_state_init(&whole);
+        ws_state_init(&split);
+        strcpy(whole.monitor_name, "DP-1");
+        strcpy(split.monitor_name, "DP-1");
+
+        replay_events(&whole, stream, stream_len, 0);
+        replay_events(&split, stream, stream_len, chunks[n]);
+        if (memcmp(&whole, &split, sizeof(whole)) != 0) {
+            fprintf(stderr, "recorded stream: state differs with %zu-byte reads\n", chunks[n]);
+            test_failures++;
+        }
+    }
+
+    // Every split point of a short stream, including inside ">>"
+    for (size_t chunk = 1; chunk <= strlen(small); chunk++) {
+        ws_state_init(&whole);
+        ws_state_init(&split);
+        strcpy(whole.monitor_name, "DP-1");
+        strcpy(split.monitor_name, "DP-1");
+
+        size_t applied = replay_events(&whole, small, strlen(small), 0);
+        CHECK_INT("events applied", replay_events(&split, small, strlen(small), chunk), applied);
+        if (memcmp(&whole, &split, sizeof(whole)) != 0) {
+            fprintf(stderr, "short stream: state differs with %zu-byte reads\n", chunk);
+            test_failures++;
+        }
+    }
+
+    // An incomplete final line is never applied
+    ws_state_init(&split);
+    strcpy(split.monitor_name, "DP-1");
+    CHECK_INT("partial line", replay_events(&split, "workspace>>2", 12, 0), 0);
+}
+
+static char* read_file(const char* path, size_t* len) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    *len = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* data = malloc(*len);
+    if (data && fread(data, 1, *len, fp) != *len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    return data;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s STREAM\n", argv[0]);
+        return 2;
+    }
+    size_t stream_len;
+    char* stream = read_file(argv[1], &stream_len);
+    if (!stream) {
+        perror(argv[1]);
+        return 2;
+    }
+
+    test_workspaces();
+    test_clients();
+    test_client_flags();
+    test_reconcile_untracked();
+    test_truncated(workspaces_reply, parse_workspaces_any, "workspaces");
+    test_truncated(clients_reply, parse_clients_any, "clients");
+    test_truncated(clients_reply, parse_client_flags_any, "client flags");
+    test_fragmented(stream, stream_len);
+
+    free(stream);
+    return test_result("parse");
+}
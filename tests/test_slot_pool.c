@@ -0,0 +1,224 @@
+/**
+ * Button slot pool: slots are reused across workspace sets, created only
+ * when every slot is in use, and moved only when the order changes.
+ *
+ * The callbacks replay create/bind/move on a mirror of the container's
+ * child order. After every update its shown slots, in order, must show the
+ * requested workspaces.
+ */
+
+#include "slot_pool.h"
+#include "test_util.h"
+
+typedef struct {
+    int children[MAX_WORKSPACES];   // Container order: slot per position
+    int count;
+    int label[MAX_WORKSPACES];      // Workspace each slot was last bound to
+    unsigned long creates, binds, moves;
+} Mirror;
+
+static void mirror_create(void* user_data, int slot) {
+    Mirror* m = user_data;
+    CHECK_INT("created slot", slot, m->count);
+    m->children[m->count++] = slot;
+    m->creates++;
+}
+
+static void mirror_bind(void* user_data, int slot, int workspace) {
+    Mirror* m = user_data;
+    m->label[slot] = workspace;
+    m->binds++;
+}
+
+// gtk_box_reorder_child() semantics
+static void mirror_move(void* user_data, int slot, int position) {
+    Mirror* m = user_data;
+    int from = -1;
+    for (int p = 0; p < m->count; p++) {
+        if (m->children[p] == slot) from = p;
+    }
+    CHECK(from >= 0);
+    if (from < 0) return;
+    if (from < position) {
+        memmove(&m->children[from], &m->children[from + 1], (size_t)(position - from) * sizeof(int));
+    } else {
+        memmove(&m->children[position + 1], &m->children[position], (size_t)(from - position) * sizeof(int));
+    }
+    m->children[position] = slot;
+    m->moves++;
+}
+
+static const SlotPoolOps mirror_ops = { mirror_create, mirror_bind, mirror_move };
+
+static SlotPool pool;
+static Mirror mirror;
+
+static void reset(void) {
+    slot_pool_init(&pool);
+    memset(&mirror, 0, sizeof(mirror));
+}
+
+// Update and check the mirror's shown slots show workspaces in order
+static void update(const int* workspaces, int count) {
+    int shown = 0;
+    slot_pool_update(&pool, workspaces, count, &mirror_ops, &mirror);
+    for (int p = 0; p < mirror.count; p++) {
+        int slot = mirror.children[p];
+        if (!slot_pool_shown(&pool, slot)) continue;
+        if (shown >= count || mirror.label[slot] != workspaces[shown]) {
+            fprintf(stderr, "shown slot %d (%d) shows %d, expected %d\n", shown, slot,
+                    mirror.label[slot], shown < count ? workspaces[shown] : 0);
+            test_failures++;
+        }
+        shown++;
+    }
+    CHECK_INT("shown slots", shown, count);
+    CHECK_INT("pool/mirror slot count", pool.count, mirror.count);
+}
+
+static void test_basic(void) {
+    reset();
+    update((const int[]){ 1, 2, 3 }, 3);
+    CHECK_INT("creates", mirror.creates, 3);
+    CHECK_INT("binds", mirror.binds, 3);
+    CHECK_INT("moves", mirror.moves, 0);
+
+    // Same set: nothing to do
+    update((const int[]){ 1, 2, 3 }, 3);
+    CHECK_INT("creates", mirror.creates, 3);
+    CHECK_INT("binds", mirror.binds, 3);
+    CHECK_INT("moves", mirror.moves, 0);
+
+    // Appearing in the middle: one new slot moved into place, nothing rebound
+    update((const int[]){ 1, 2, 4, 3 }, 4);
+    update((const int[]){ 1, 2, 3, 4 }, 4);
+    CHECK_INT("creates", mirror.creates, 4);
+    CHECK_INT("binds", mirror.binds, 4);
+
+    // Disappearing: the rest keep their slots and places, the gap is just hidden
+    unsigned long moves = mirror.moves;
+    update((const int[]){ 1, 3, 4 }, 3);
+    CHECK_INT("binds after removal", mirror.binds, 4);
+    CHECK_INT("moves after removal", mirror.moves - moves, 0);
+
+    // Coming back finds its old slot still bound
+    update((const int[]){ 1, 2, 3, 4 }, 4);
+    CHECK_INT("binds after return", mirror.binds, 4);
+    CHECK_INT("creates after return", mirror.creates, 4);
+}
+
+// 1-9 plus one of 10..50 at a time: after warm-up no slot is ever created
+static void test_cycle(void) {
+    int workspaces[10];
+    reset();
+    for (int i = 0; i < 9; i++) {
+        workspaces[i] = i + 1;
+    }
+    for (int round = 0; round < 3; round++) {
+        for (int extra = 10; extra <= 50; extra++) {
+            workspaces[9] = extra;
+            update(workspaces, 10);
+        }
+    }
+    CHECK_INT("creates while cycling", mirror.creates, 10);
+    CHECK_INT("pool size", pool.count, 10);
+    CHECK_INT("moves while cycling", mirror.moves, 0);
+}
+
+// Random sorted subsets: the pool never holds more slots than the largest set
+static void test_random(void) {
+    unsigned seed = 7;
+    int largest = 0;
+    reset();
+    for (int iter = 0; iter < 2000; iter++) {
+        int workspaces[MAX_WORKSPACES];
+        int count = 0;
+        for (int ws = 1; ws <= 60; ws++) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 4 == 0) workspaces[count++] = ws;
+        }
+        if (count > largest) largest = count;
+        update(workspaces, count);
+    }
+    CHECK(pool.count <= largest);
+    CHECK_INT("mirror creates", mirror.creates, pool.created);
+    CHECK_INT("mirror moves", mirror.moves, pool.moves);
+}
+
+static void test_window(void) {
+    CHECK_INT("all fit", slot_window_first(5, 8, 10, 7), 0);
+    CHECK_INT("in range", slot_window_first(5, 100, 10, -1), 5);
+    CHECK_INT("past the end", slot_window_first(95, 100, 10, -1), 90);
+    CHECK_INT("before the start", slot_window_first(-3, 100, 10, -1), 0);
+    CHECK_INT("keep inside", slot_window_first(5, 100, 10, 14), 5);
+    CHECK_INT("keep left", slot_window_first(50, 100, 10, 20), 20);
+    CHECK_INT("keep right", slot_window_first(5, 100, 10, 40), 31);
+}
+
+// 150 workspaces through a 12-slot window, scrolled end to end and back:
+// the pool stays at the window size and each step rebinds one slot
+static void test_scroll(void) {
+    int workspaces[MAX_WORKSPACES];
+    const int count = 150, visible = 12;
+    reset();
+    for (int i = 0; i < count; i++) {
+        workspaces[i] = i + 1;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (int step = 0; step < count; step++) {
+            int first = slot_window_first(pass ? count - step : step, count, visible, -1);
+            update(workspaces + first, visible);
+        }
+    }
+    CHECK_INT("creates while scrolling", mirror.creates, visible);
+    CHECK(mirror.binds <= (unsigned long)(visible + 2 * (count - visible)));
+}
+
+// Stable layout: hidden slots keep their space, so all of them stay in
+// workspace order while workspaces empty, refill and take each other's slots
+static void test_keep_space(void) {
+    unsigned seed = 11;
+    reset();
+    pool.keep_space = 1;
+
+    update((const int[]){ 1, 2, 3, 4 }, 4);
+    update((const int[]){ 1, 3, 4 }, 3);
+    CHECK_INT("emptied: gap stays", mirror.moves, 0);
+    update((const int[]){ 1, 3, 4, 6 }, 4);
+    CHECK_INT("stale slot reused", mirror.creates, 4);
+    CHECK_INT("moved once", mirror.moves, 1);
+    update((const int[]){ 1, 2, 3, 4, 6 }, 5);
+    CHECK_INT("refill creates", mirror.creates, 5);
+    CHECK_INT("moved into its place", mirror.moves, 2);
+
+    for (int iter = 0; iter < 2000; iter++) {
+        int workspaces[MAX_WORKSPACES];
+        int count = 0;
+        for (int ws = 1; ws <= 30; ws++) {
+            seed = seed * 1103515245u + 12345u;
+            if ((seed >> 16) % 3 == 0) workspaces[count++] = ws;
+        }
+        update(workspaces, count);
+
+        int previous = 0;
+        for (int p = 0; p < mirror.count; p++) {
+            int workspace = pool.slot_workspace[mirror.children[p]];
+            if (workspace != 0 && workspace < previous) {
+                fprintf(stderr, "slot %d out of order (%d after %d)\n", p, workspace, previous);
+                test_failures++;
+            }
+            if (workspace != 0) previous = workspace;
+        }
+    }
+    CHECK_INT("mirror moves", mirror.moves, pool.moves);
+}
+
+int main(void) {
+    test_basic();
+    test_cycle();
+    test_random();
+    test_window();
+    test_scroll();
+    test_keep_space();
+    return test_result("slot_pool");
+}
@@ -0,0 +1,113 @@
+/**
+ * Shared helpers for the test programs: failure-counting checks and a
+ * replay driver that feeds socket2 text to a WorkspaceState the way the
+ * module's reader and state worker do.
+ */
+
+#pragma once
+
+#include "event_queue.h"
+#include "event_scan.h"
+#include "workspace_state.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_BUFFER 4096
+#define REPLAY_SPANS 64
+
+static int test_failures __attribute__((unused));
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_INT(what, actual, expected) \
+    do { \
+        long long actual_ = (actual), expected_ = (expected); \
+        if (actual_ != expected_) { \
+            fprintf(stderr, "%s:%d: %s: got %lld, expected %lld\n", __FILE__, __LINE__, \
+                    (what), actual_, expected_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_STR(what, actual, expected) \
+    do { \
+        const char* actual_ = (actual); \
+        const char* expected_ = (expected); \
+        if (strcmp(actual_, expected_) != 0) { \
+            fprintf(stderr, "%s:%d: %s: got \"%s\", expected \"%s\"\n", __FILE__, __LINE__, \
+                    (what), actual_, expected_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+static EventQueue replay_queue;
+
+// Apply everything queued, as the state worker does after a wakeup.
+// Unresolvable window events leave refresh_pending set for the caller.
+static inline size_t replay_drain(WorkspaceState* st) {
+    const HyprEvent* event;
+    size_t applied = 0;
+    while ((event = event_queue_peek(&replay_queue)) != NULL) {
+        ws_state_apply_event(st, event);
+        event_queue_pop(&replay_queue);
+        applied++;
+    }
+    return applied;
+}
+
+// Feed text to st in reads of at most chunk bytes, keeping incomplete lines
+// between reads like the reader does. Returns the number of events applied.
+static inline size_t replay_events(WorkspaceState* st, const char* text, size_t len, size_t chunk) {
+    char buffer[REPLAY_BUFFER];
+    EventSpan spans[REPLAY_SPANS];
+    size_t pending = 0;
+    size_t applied = 0;
+
+    if (chunk == 0 || chunk > sizeof(buffer)) chunk = sizeof(buffer);
+    for (size_t offset = 0; offset < len;) {
+        size_t bytes = sizeof(buffer) - pending;
+        if (bytes > chunk) bytes = chunk;
+        if (bytes > len - offset) bytes = len - offset;
+        memcpy(buffer + pending, text + offset, bytes);
+        offset += bytes;
+
+        size_t total = pending + bytes;
+        size_t start = 0;
+        size_t count;
+        do {
+            size_t consumed;
+            count = event_scan_lines(buffer + start, total - start, spans, REPLAY_SPANS, &consumed);
+            for (size_t i = 0; i < count; i++) {
+                if (spans[i].len == 0) continue;
+                const char* line = buffer + start + spans[i].start;
+                // Drain before the queue fills, so no title is ever parked
+                if (event_queue_depth(&replay_queue) == EVENT_QUEUE_CAPACITY) {
+                    applied += replay_drain(st);
+                }
+                event_queue_push_line(&replay_queue, line, &spans[i]);
+            }
+            start += consumed;
+        } while (count == REPLAY_SPANS);
+
+        pending = total - start;
+        if (pending == sizeof(buffer)) pending = 0;  // Overlong line, dropped
+        memmove(buffer, buffer + start, pending);
+        applied += replay_drain(st);
+    }
+    return applied;
+}
+
+static inline int test_result(const char* name) {
+    if (test_failures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
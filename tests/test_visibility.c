@@ -0,0 +1,149 @@
+/**
+ * Visibility matrix and CSS classes computed by ws_state_render().
+ *
+ * Every combination of all-outputs, show-empty, workspace monitor and
+ * workspace contents is checked against a literal expectation table, so a
+ * change to the rules has to change the table too.
+ */
+
+#include "test_util.h"
+
+enum { MON_THIS, MON_OTHER, MON_UNKNOWN, MON_COUNT };
+enum { CONTENT_EMPTY, CONTENT_WINDOWS, CONTENT_SPECIAL_ONLY, CONTENT_COUNT };
+
+static const char* monitor_names[MON_COUNT] = { "this", "other", "unknown" };
+static const char* content_names[CONTENT_COUNT] = { "empty", "windows", "special-only" };
+
+// expected[all_outputs][show_empty]: one digit per (monitor, content) pair,
+// monitor-major, for a workspace that is not this monitor's active one
+static const char* expected[2][2] = {
+    //           this  other unknown
+    { /* se=0 */ "011" "000" "011",
+      /* se=1 */ "111" "000" "111" },
+    { /* se=0 */ "011" "011" "011",
+      /* se=1 */ "111" "111" "111" },
+};
+
+static void setup(WorkspaceState* st, int ws_index, int monitor, int content) {
+    ws_state_init(st);
+    strcpy(st->monitor_name, "DP-1");
+    strcpy(st->focused_monitor, "DP-1");
+    st->this_monitor_workspace = ws_index == 0 ? 2 : 1;
+
+    if (monitor == MON_THIS) ws_state_set_workspace_monitor(st, ws_index + 1, "DP-1");
+    if (monitor == MON_OTHER) ws_state_set_workspace_monitor(st, ws_index + 1, "HDMI-A-1");
+    if (content == CONTENT_WINDOWS) st->workspace_windows[ws_index] = 1;
+    if (content == CONTENT_SPECIAL_ONLY) st->special_windows[ws_index] = 1;
+}
+
+static void test_matrix(void) {
+    static WorkspaceState st;
+    const int ws_index = 4;
+
+    for (int ao = 0; ao < 2; ao++) {
+        for (int se = 0; se < 2; se++) {
+            WorkspaceViewConfig config = { .all_outputs = ao, .show_empty = se };
+            for (int mon = 0; mon < MON_COUNT; mon++) {
+                for (int content = 0; content < CONTENT_COUNT; content++) {
+                    setup(&st, ws_index, mon, content);
+                    int want = expected[ao][se][mon * CONTENT_COUNT + content] - '0';
+                    int got = ws_state_should_show(&st, &config, ws_index);
+                    if (got != want) {
+                        fprintf(stderr, "all-outputs=%d show-empty=%d monitor=%s content=%s: "
+                                "shown=%d, expected %d\n", ao, se, monitor_names[mon],
+                                content_names[content], got, want);
+                        test_failures++;
+                    }
+
+                    // This monitor's active workspace is shown no matter what
+                    st.this_monitor_workspace = ws_index + 1;
+                    CHECK(ws_state_should_show(&st, &config, ws_index));
+                }
+            }
+        }
+    }
+}
+
+// Before detection every workspace counts as being on this monitor
+static void test_undetected_monitor(void) {
+    static WorkspaceState st;
+    WorkspaceViewConfig config = { .all_outputs = 0, .show_empty = 0 };
+
+    setup(&st, 4, MON_OTHER, CONTENT_WINDOWS);
+    st.monitor_name[0] = '\0';
+    CHECK(ws_state_should_show(&st, &config, 4));
+}
+
+static void test_classes(void) {
+    static WorkspaceState st;
+    WorkspaceViewConfig config = { .all_outputs = 0, .show_empty = 1 };
+    WorkspaceRender render;
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    st.this_monitor_workspace = 2;
+    st.user_focused_here = 1;
+    st.workspace_windows[1] = 3;
+    st.special_windows[3] = 1;
+    ws_state_set_workspace_monitor(&st, 7, "HDMI-A-1");
+
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("ws 2 classes", render.buttons[1].classes, WS_CLASS_ACTIVE);
+    CHECK_INT("ws 1 classes", render.buttons[0].classes, WS_CLASS_EMPTY);
+    CHECK_INT("ws 4 classes", render.buttons[3].classes, WS_CLASS_HAS_SPECIAL);
+    CHECK_INT("ws 7 shown", render.buttons[6].shown, 0);
+    CHECK_INT("ws 7 classes", render.buttons[6].classes, 0);
+
+    // Focus on another monitor: the workspace is only "visible" here
+    st.user_focused_here = 0;
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("ws 2 classes unfocused", render.buttons[1].classes, WS_CLASS_VISIBLE);
+
+    // An empty active workspace is both
+    st.workspace_windows[1] = 0;
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("ws 2 classes empty", render.buttons[1].classes, WS_CLASS_VISIBLE | WS_CLASS_EMPTY);
+}
+
+// Badge counts and count threshold levels come straight from the counts
+static void test_counts(void) {
+    static WorkspaceState st;
+    WorkspaceViewConfig config = { .show_empty = 1, .count_levels = { 2, 5 }, .count_level_count = 2 };
+    WorkspaceRender render;
+
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+    st.workspace_windows[0] = 1;
+    st.workspace_windows[1] = 2;
+    st.workspace_windows[2] = 7;
+    st.special_windows[2] = 3;
+
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("ws 1 level", render.buttons[0].level, 0);
+    CHECK_INT("ws 2 level", render.buttons[1].level, 1);
+    CHECK_INT("ws 3 level", render.buttons[2].level, 2);
+    CHECK_INT("ws 4 level", render.buttons[3].level, 0);
+    CHECK_INT("ws 3 windows", render.buttons[2].windows, 7);
+    CHECK_INT("ws 3 special", render.buttons[2].special, 3);
+
+    // Levels follow the incremental counts
+    const char* events = "closewindow>>a\nopenwindow>>b1,1,kitty,~\n";
+    ws_state_add_window(&st, 0xa, 3, 0, 0, NULL);
+    replay_events(&st, events, strlen(events), 0);
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("ws 1 level after", render.buttons[0].level, 1);
+    CHECK_INT("ws 3 windows after", render.buttons[2].windows, 6);
+    CHECK_INT("no refresh", st.refresh_pending, 0);
+
+    config.count_level_count = 0;
+    ws_state_render(&st, &config, &render);
+    CHECK_INT("no thresholds", render.buttons[2].level, 0);
+}
+
+int main(void) {
+    test_matrix();
+    test_undetected_monitor();
+    test_classes();
+    test_counts();
+    return test_result("visibility");
+}
@@ -0,0 +1,184 @@
+/**
+ * Tooltip window lists: titles kept in the window table, the per-workspace
+ * serial that decides when a list is rebuilt, and title events leaving the
+ * render alone.
+ */
+
+#include "hyprctl_parse.h"
+#include "test_util.h"
+
+static void apply(WorkspaceState* st, const char* text) {
+    replay_events(st, text, strlen(text), 0);
+}
+
+static void setup(WorkspaceState* st) {
+    ws_state_init(st);
+    strcpy(st->monitor_name, "DP-1");
+    apply(st, "openwindow>>a1,1,kitty,shell\n"
+              "openwindow>>a2,1,firefox,Docs, part 2\n"
+              "openwindow>>a3,1,kitty,htop\n"
+              "openwindow>>b1,2,mpv,\n");
+}
+
+static void test_list(void) {
+    static WorkspaceState st;
+    WindowListCache cache = { 0 };
+    setup(&st);
+
+    CHECK_INT("built", ws_state_window_list(&st, 1, &cache), 1);
+    CHECK_INT("windows", cache.windows, 3);
+    CHECK_STR("text", cache.text, "firefox: Docs, part 2\nkitty: htop\nkitty: shell");
+    CHECK_INT("current", ws_state_window_list(&st, 1, &cache), 0);
+
+    // No title: just the class
+    CHECK_INT("other workspace", ws_state_window_list(&st, 2, &cache), 1);
+    CHECK_STR("untitled", cache.text, "mpv");
+
+    CHECK_INT("empty workspace", ws_state_window_list(&st, 7, &cache), 1);
+    CHECK_INT("no windows", cache.windows, 0);
+    CHECK_STR("no text", cache.text, "");
+}
+
+// Titles only touch their own workspace's list, and never the render
+static void test_title_events(void) {
+    static WorkspaceState st;
+    WindowListCache ws1 = { 0 };
+    WindowListCache ws2 = { 0 };
+    setup(&st);
+    ws_state_window_list(&st, 1, &ws1);
+    ws_state_window_list(&st, 2, &ws2);
+
+    HyprEvent event = { .type = EVENT_WINDOWTITLE };
+    strcpy(event.payload, "a3,top - 12:00:01");
+    CHECK_INT("no render change", ws_state_apply_event(&st, &event), 0);
+    CHECK_INT("ws2 untouched", ws_state_window_list(&st, 2, &ws2), 0);
+    CHECK_INT("ws1 rebuilt", ws_state_window_list(&st, 1, &ws1), 1);
+    CHECK_STR("new title", ws1.text, "firefox: Docs, part 2\nkitty: shell\nkitty: top - 12:00:01");
+
+    strcpy(event.payload, "ffff,unknown window");
+    CHECK_INT("unknown window", ws_state_apply_event(&st, &event), 0);
+    CHECK_INT("no refresh", st.refresh_pending, 0);
+
+    event.type = EVENT_MOVEWINDOW;
+    strcpy(event.payload, "a1,2");
+    CHECK_INT("move changes render", ws_state_apply_event(&st, &event), 1);
+    CHECK_INT("ws1 after move", ws_state_window_list(&st, 1, &ws1), 1);
+    CHECK_INT("ws2 after move", ws_state_window_list(&st, 2, &ws2), 1);
+    CHECK_STR("moved", ws2.text, "kitty: shell\nmpv");
+
+    // Closing moves table entries around; titles must follow them
+    apply(&st, "closewindow>>a2\n");
+    ws_state_window_list(&st, 1, &ws1);
+    CHECK_STR("after close", ws1.text, "kitty: top - 12:00:01");
+}
+
+// Long titles are cut at a character boundary; long lists are capped
+static void test_limits(void) {
+    static WorkspaceState st;
+    WindowListCache cache = { 0 };
+    char line[WINDOW_TITLE_MAX * 3];
+    ws_state_init(&st);
+    strcpy(st.monitor_name, "DP-1");
+
+    int len = snprintf(line, sizeof(line), "openwindow>>c0,3,app,");
+    for (int i = 0; i < WINDOW_TITLE_MAX; i++) {
+        line[len++] = (char)0xC3;
+        line[len++] = (char)0xA9;
+    }
+    line[len++] = '\n';
+    replay_events(&st, line, (size_t)len, 0);
+    ws_state_window_list(&st, 3, &cache);
+    size_t title_len = strlen(cache.text) - strlen("app: ");
+    CHECK_INT("title length", title_len, WINDOW_TITLE_MAX - 2);
+
+    for (int i = 1; i < WINDOW_LIST_LINES_MAX + 5; i++) {
+        snprintf(line, sizeof(line), "openwindow>>c%d,4,app,t%02d\n", i, i);
+        apply(&st, line);
+    }
+    ws_state_window_list(&st, 4, &cache);
+    CHECK_INT("windows", cache.windows, WINDOW_LIST_LINES_MAX + 4);
+    const char* more = strrchr(cache.text, '\n');
+    CHECK_STR("more", more ? more + 1 : "", "+4 more");
+}
+
+// Titles from the clients reply, escapes decoded; reseeding invalidates lists
+static void test_clients_titles(void) {
+    static WorkspaceState st;
+    WindowListCache cache = { 0 };
+    ws_state_init(&st);
+    const char* reply =
+        "[{\"address\": \"0xd1\", \"class\": \"code\", \"title\": \"a \\\"b\\\"\\tc\\u001b\","
+        " \"workspace\": {\"id\": 5, \"name\": \"5\"}}]";
+    CHECK_INT("parse", hyprctl_parse_clients(reply, &st), 0);
+    CHECK_INT("built", ws_state_window_list(&st, 5, &cache), 1);
+    CHECK_STR("title", cache.text, "code: a \"b\" c");
+
+    CHECK_INT("reparse", hyprctl_parse_clients(reply, &st), 0);
+    CHECK_INT("rebuilt after reseed", ws_state_window_list(&st, 5, &cache), 1);
+}
+
+static int push(EventQueue* q, const char* line) {
+    EventSpan span;
+    size_t consumed;
+    event_scan_lines(line, strlen(line), &span, 1, &consumed);
+    return event_queue_push_line(q, line, &span);
+}
+
+// Events that find the queue full are parked and queued ahead of later ones:
+// titles newest per window, workspace>> runs only the last
+static void test_parked_events(void) {
+    static EventQueue q;
+    for (int i = 0; i < EVENT_QUEUE_CAPACITY; i++) push(&q, "workspace>>1\n");
+
+    CHECK_INT("parked", push(&q, "windowtitlev2>>a1,one\n"), 0);
+    CHECK_INT("other window", push(&q, "windowtitlev2>>a2,x\n"), 0);
+    CHECK_INT("coalesced", push(&q, "windowtitlev2>>a1,two\n"), 0);
+    CHECK_INT("parked count", q.parked_count, 2);
+    CHECK_INT("coalesced count", q.coalesced, 1);
+    CHECK_INT("nothing dropped", q.dropped, 0);
+
+    for (int i = 0; i < 3; i++) event_queue_pop(&q);
+    CHECK_INT("queued behind titles", push(&q, "workspace>>2\n"), 1);
+    for (int i = 0; i < EVENT_QUEUE_CAPACITY - 3; i++) event_queue_pop(&q);
+    const HyprEvent* event = event_queue_peek(&q);
+    CHECK_STR("newest a1 title", event ? event->payload : "", "a1,two");
+    event_queue_pop(&q);
+    event = event_queue_peek(&q);
+    CHECK_STR("a2 title", event ? event->payload : "", "a2,x");
+    event_queue_pop(&q);
+    event = event_queue_peek(&q);
+    CHECK_INT("then the workspace", event ? (int)event->type : -1, EVENT_WORKSPACE);
+    event_queue_pop(&q);
+
+    // Other events keep their order; a run of switches only keeps the last
+    for (int i = 0; i < EVENT_QUEUE_CAPACITY; i++) push(&q, "workspace>>1\n");
+    push(&q, "workspace>>2\n");
+    push(&q, "workspace>>3\n");
+    push(&q, "closewindow>>a1\n");
+    push(&q, "windowtitlev2>>a2,y\n");
+    push(&q, "workspace>>4\n");
+    CHECK_INT("parked in order", q.parked_count, 4);
+    CHECK_STR("last of the run", q.parked[0].payload, "3");
+    CHECK_INT("then the close", (int)q.parked[1].type, EVENT_CLOSEWINDOW);
+    CHECK_STR("not across the close", q.parked[3].payload, "4");
+    CHECK_INT("nothing dropped yet", q.dropped, 0);
+
+    // Only once nothing more can be parked is an event dropped
+    char line[64];
+    for (int i = 0; q.parked_count < EVENT_PARKED_MAX; i++) {
+        snprintf(line, sizeof(line), "closewindow>>%x\n", 0x100 + i);
+        push(&q, line);
+    }
+    CHECK_INT("dropped", push(&q, "closewindow>>a1\n"), -1);
+    CHECK_INT("dropped count", q.dropped, 1);
+    CHECK_INT("parked events go too", q.parked_count, 0);
+}
+
+int main(void) {
+    test_list();
+    test_title_events();
+    test_limits();
+    test_clients_titles();
+    test_parked_events();
+    return test_result("window_list");
+}